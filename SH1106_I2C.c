@@ -32,6 +32,13 @@
 
 #include "SH1106_I2C.h"
 
+//IMAGE IMPORT KERNELS ARE VECTORIZED WHEN BUILT FOR A HOST THAT HAS SIMD
+#if defined(__SSE2__)
+	#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+	#include <arm_neon.h>
+#endif
+
 //LOCAL LIBRARY VARIABLES////////////////////////////////
 //DEBUG RELATED
 static uint8_t _sh1106_i2c_debug;
@@ -39,8 +46,110 @@ static uint8_t _sh1106_i2c_debug;
 //DEVICE RELATED
 static uint8_t _sh1106_i2c_slave_address;
 static uint8_t* _sh1106_framebuffer_pointer;
+static uint8_t _sh1106_i2c_orientation = SH1106_I2C_ORIENTATION_ROTATE_0;
+static uint8_t _sh1106_i2c_column_offset = SH1106_I2C_OLED_COLUMN_OFFSET;
+static uint8_t _sh1106_i2c_contrast;
+static uint8_t _sh1106_i2c_display_on;
+static uint8_t _sh1106_i2c_inverted;
+
+#ifdef SH1106_I2C_DIRECT_MODE
+//DIRECT MODE RELATED
+static SH1106_I2C_DIRECT_STATS _sh1106_i2c_direct_stats;
+#endif
+
+//TRANSPORT RELATED
+static uint8_t _sh1106_i2c_transaction_nacked;
+static uint8_t _sh1106_i2c_suspect_page_mask;
+static SH1106_I2C_TRANSPORT_STATS _sh1106_i2c_transport_stats;
+
+//WARM RESUME RELATED
+static SH1106_I2C_RESUME_RECORD _sh1106_i2c_resume_record;
+static uint8_t _sh1106_i2c_resume_pending;
+//SET WHEN THE DISPLAY RAM MAY DIFFER FROM THE FRAMEBUFFER OUTSIDE THE DIRTY AREA
+//(STREAMED FRAMES, RAW PAGE DATA, GRAY PLANES, A FAILED PLANE SWITCH, RANDOM RAM AFTER
+//INIT, A WARM RESUME NOT FLUSHED YET). CLEARED ONCE THE WHOLE SCREEN IS DIRTY OR SENT
+static uint8_t _sh1106_i2c_ram_out_of_sync;
+
+//REFRESH SCHEDULER RELATED
+//A PAGE IS DIRTY WHEN ITS BIT IS SET IN THE MASK. ITS DIRTY COLUMNS
+//ARE THEN [_sh1106_i2c_dirty_column_start, _sh1106_i2c_dirty_column_end]
+static os_timer_t _sh1106_i2c_scheduler_timer;
+static uint8_t _sh1106_i2c_scheduler_running;
+static uint8_t _sh1106_i2c_dirty_page_mask;
+static uint8_t _sh1106_i2c_dirty_column_start[SH1106_I2C_OLED_MAX_PAGE + 1];
+static uint8_t _sh1106_i2c_dirty_column_end[SH1106_I2C_OLED_MAX_PAGE + 1];
+static SH1106_I2C_SCHEDULER_STATS _sh1106_i2c_scheduler_stats;
+
+//EFFECTS ENGINE RELATED
+static os_timer_t _sh1106_i2c_effect_timer;
+static SH1106_I2C_EFFECT_STEP _sh1106_i2c_effect_steps[SH1106_I2C_EFFECT_MAX_STEPS];
+static uint8_t _sh1106_i2c_effect_step_count;
+static uint8_t _sh1106_i2c_effect_step_index;
+static uint8_t _sh1106_i2c_effect_running;
+static uint8_t _sh1106_i2c_effect_repeat;
+static SH1106_I2C_EFFECT_DONE_CALLBACK _sh1106_i2c_effect_done_cb;
+
+//GRAYSCALE RELATED
+//THE FRAMEBUFFER IS THE MSB PLANE. PAGES SET IN THE MASK DIFFER BETWEEN THE PLANES IN
+//COLUMNS [_sh1106_i2c_gray_span_start, _sh1106_i2c_gray_span_end]
+static os_timer_t _sh1106_i2c_gray_timer;
+static uint8_t* _sh1106_i2c_gray_lsb_plane;
+static uint8_t _sh1106_i2c_gray_plane;
+static uint8_t _sh1106_i2c_gray_contrast;
+static uint8_t _sh1106_i2c_gray_plane_rate;
+static uint32_t _sh1106_i2c_gray_bus_hz;
+static uint8_t _sh1106_i2c_gray_degraded;
+static uint8_t _sh1106_i2c_gray_page_mask;
+static uint8_t _sh1106_i2c_gray_overruns;
+static uint8_t _sh1106_i2c_gray_span_start[SH1106_I2C_OLED_MAX_PAGE + 1];
+static uint8_t _sh1106_i2c_gray_span_end[SH1106_I2C_OLED_MAX_PAGE + 1];
+
+//IMAGE IMPORT RELATED
+//4x4 BAYER MATRIX FOR ORDERED DITHERING
+static const uint8_t _sh1106_i2c_bayer_4x4[4][4] = {{0, 8, 2, 10}, {12, 4, 14, 6}, {3, 11, 1, 9}, {15, 7, 13, 5}};
+
+//TEXT LAYOUT RELATED
+//PER FONT GLYPH ADVANCE (PIXELS) TABLES, KEYED ON THE FONT BITMAP
+static const uint8_t* _sh1106_i2c_font_cache_key[SH1106_I2C_TEXT_FONT_CACHE_SIZE];
+static uint8_t* _sh1106_i2c_font_cache_advance[SH1106_I2C_TEXT_FONT_CACHE_SIZE];
+static uint8_t _sh1106_i2c_font_cache_next;
 //END LOCAL LIBRARY VARIABLES/////////////////////////////
 
+//LOCAL LIBRARY FUNCTIONS/////////////////////////////////
+static uint8_t PUT_FUNCTION_IN_FLASH _sh1106_i2c_send_init_commands(void);
+static uint8_t PUT_FUNCTION_IN_FLASH _sh1106_i2c_clear_display_ram(void);
+static void PUT_FUNCTION_IN_FLASH _sh1106_i2c_update_column_offset(void);
+static uint16_t PUT_FUNCTION_IN_FLASH _sh1106_i2c_checksum(const uint8_t* data, uint16_t len);
+static void PUT_FUNCTION_IN_FLASH _sh1106_i2c_transaction_start(void);
+static void PUT_FUNCTION_IN_FLASH _sh1106_i2c_transaction_send(uint8_t byte);
+static uint8_t PUT_FUNCTION_IN_FLASH _sh1106_i2c_transaction_stop(void);
+static uint8_t PUT_FUNCTION_IN_FLASH _sh1106_i2c_set_cursor(uint8_t page, uint8_t ram_column);
+#ifdef SH1106_I2C_DIRECT_MODE
+static void PUT_FUNCTION_IN_FLASH _sh1106_i2c_direct_send(uint8_t byte);
+static uint8_t PUT_FUNCTION_IN_FLASH _sh1106_i2c_direct_command(const uint8_t* commands, uint8_t command_count);
+static uint8_t PUT_FUNCTION_IN_FLASH _sh1106_i2c_direct_update_span(uint8_t page, uint8_t x_start, uint8_t x_end, uint8_t mask, uint8_t color);
+#endif
+static uint8_t PUT_FUNCTION_IN_FLASH _sh1106_i2c_send_page_span(uint8_t page, uint8_t x_start, uint8_t x_end);
+static uint8_t PUT_FUNCTION_IN_FLASH _sh1106_i2c_send_page_data(uint8_t page, uint8_t x_start, const uint8_t* data, uint16_t len);
+static uint8_t PUT_FUNCTION_IN_FLASH _sh1106_i2c_send_ram_data(uint8_t page, uint8_t ram_column, const uint8_t* data, uint16_t len);
+static void PUT_FUNCTION_IN_FLASH _sh1106_i2c_scheduler_timer_cb(void* arg);
+static void PUT_FUNCTION_IN_FLASH _sh1106_i2c_effect_timer_cb(void* arg);
+static void PUT_FUNCTION_IN_FLASH _sh1106_i2c_effect_track_state(const SH1106_I2C_EFFECT_STEP* step);
+static void PUT_FUNCTION_IN_FLASH _sh1106_i2c_gray_timer_cb(void* arg);
+static uint8_t PUT_FUNCTION_IN_FLASH _sh1106_i2c_gray_show_plane(uint8_t plane);
+static uint8_t PUT_FUNCTION_IN_FLASH _sh1106_i2c_gray_send_contrast(uint8_t plane);
+static void PUT_FUNCTION_IN_FLASH _sh1106_i2c_gray_scan_page(uint8_t page);
+static void PUT_FUNCTION_IN_FLASH _sh1106_i2c_gray_arm(void);
+static void PUT_FUNCTION_IN_FLASH _sh1106_i2c_gray_invalidate_spans(void);
+static uint8_t PUT_FUNCTION_IN_FLASH _sh1106_i2c_image_import_frames(const uint8_t* const* frames, uint16_t frame_count, uint16_t width, uint16_t height, uint16_t stride, uint8_t bytes_per_pixel, uint8_t mode, uint8_t threshold, uint8_t* dest, uint16_t dest_width);
+static void PUT_FUNCTION_IN_FLASH _sh1106_i2c_image_import(const uint8_t* image, uint16_t width, uint16_t height, uint16_t stride, uint8_t bytes_per_pixel, uint8_t mode, uint8_t threshold, uint8_t* dest, uint16_t dest_width, uint8_t* luma_rows, int16_t* error_rows);
+static void PUT_FUNCTION_IN_FLASH _sh1106_i2c_image_pack_page(const uint8_t* const* rows, uint8_t row_count, uint8_t thresholds[8][16], uint16_t width, uint8_t* dest);
+static const uint8_t* PUT_FUNCTION_IN_FLASH _sh1106_i2c_font_advance_table(const FONT_INFO* font);
+static uint8_t PUT_FUNCTION_IN_FLASH _sh1106_i2c_char_advance(const uint8_t* advance_table, const FONT_INFO* font, uint8_t c);
+static void PUT_FUNCTION_IN_FLASH _sh1106_i2c_transpose_8x8(const uint8_t* in, uint8_t* out);
+static uint8_t PUT_FUNCTION_IN_FLASH _sh1106_i2c_draw_char(uint8_t c, uint16_t x, uint16_t y, const FONT_INFO* font, uint8_t color);
+//END LOCAL LIBRARY FUNCTIONS/////////////////////////////
+
 void PUT_FUNCTION_IN_FLASH SH1106_I2C_SetDebug(uint8_t debug_on)
 {
 	//SET DEBUG PRINTF ON(1) OR OFF(0)
@@ -65,189 +174,215 @@ void PUT_FUNCTION_IN_FLASH SH1106_I2C_SetDeviceAddress(uint8_t address)
 	}
 }
 
-void PUT_FUNCTION_IN_FLASH SH1106_I2C_Init(void)
+uint8_t PUT_FUNCTION_IN_FLASH SH1106_I2C_Init(void)
 {
 	//INITIALIZE THE OLED MODULE AS PER THE DEFAULT PARAMETERS
+	//RETURNS 1 ON SUCCESS, 0 IF THE FRAMEBUFFER COULD NOT BE ALLOCATED OR THE
+	//INIT STREAM WAS NACKED (CALL AGAIN TO RETRY)
 
-	//INITIALIZE DISPLAY FRAMBUFFER
-	_sh1106_framebuffer_pointer = (uint8_t*)os_zalloc((SH1106_I2C_OLED_MAX_COLUMN + 1) * (SH1106_I2C_OLED_MAX_PAGE + 1));
+	//INITIALIZE DISPLAY FRAMBUFFER (ONLY ONCE IF INIT IS CALLED AGAIN)
+	if(_sh1106_framebuffer_pointer == NULL)
+	{
+		_sh1106_framebuffer_pointer = (uint8_t*)os_zalloc((SH1106_I2C_OLED_MAX_COLUMN + 1) * (SH1106_I2C_OLED_MAX_PAGE + 1));
+		if(_sh1106_framebuffer_pointer == NULL)
+		{
+			if(_sh1106_i2c_debug)
+			{
+				debug_printf("SH1106 : Frame buffer allocation failed\n");
+			}
+			return 0;
+		}
+	}
 
 	//INITIALIZE THE DISPLAY
-	_sh1106_i2c_send_start_function();
-
-	//SET I2C SLAVE WRITE ADDRESS
-	_sh1106_i2c_send_byte_function((_sh1106_i2c_slave_address << 1));
-
-	//SET TYPE TO COMMAND STREAM
-	_sh1106_i2c_send_byte_function(SH1106_I2C_CONTROL_BYTE_CMD_STREAM);
-
-	//DISPLAY OFF
-	_sh1106_i2c_send_byte_function(SH1106_I2C_CMD_SET_DISPLAY_OFF);
-
-	//SET COLUMN ADDRESS LOWER (2)
-	//BECAUSE THIS CONTROLLER HAS RAM SIZE 132 X 64 WHEREAS OUR DISPLAY
-	//IS 128 X 4. SO THE OLED IS MAPPED FROM RAM COLUMN 2 - COLUMN 130
-	_sh1106_i2c_send_byte_function(SH1106_I2C_CMD_SET_COLUMN_LOWER_4 | 2);
-	_sh1106_i2c_send_byte_function(SH1106_I2C_CMD_SET_COLUMN_UPPER_4 | 0);
-
-	//SET START PAGE ADDRESS = 0
-	_sh1106_i2c_send_byte_function(SH1106_I2C_CMD_SET_PAGE_ADDRESS | 0);
-
-	//SET COMMON OUTPUT SCAN DIRECTION = TOP -> BOTTOM
-	_sh1106_i2c_send_byte_function(SH1106_I2C_CMD_SET_COMMON_SCAN_DIRECTION | 8);
-
-	//_sh1106_i2c_send_byte_function(0x00);
-	//_sh1106_i2c_send_byte_function(0x10);
-
-	//SET DISPLAY START LINE = 0
-	_sh1106_i2c_send_byte_function(SH1106_I2C_CMD_SET_DISPLAY_START_LINE | 0);
-
-	//SET CONTRAST
-	_sh1106_i2c_send_byte_function(SH1106_I2C_CMD_SET_CONTRAST_CONTROL_MODE);
-	_sh1106_i2c_send_byte_function(0x7F);
-
-	//SET SEGMENT REMAP
-	_sh1106_i2c_send_byte_function(SH1106_I2C_CMD_SET_SEGMENT_REMAP | 1);
-
-	//SET DISPLAY = NORMAL
-	_sh1106_i2c_send_byte_function(SH1106_I2C_CMD_SET_DISPLAY_NORMAL);
-
-	//SET MULTIPLEX RATIO = 63 (ALL ROWS)
-	_sh1106_i2c_send_byte_function(SH1106_I2C_CMD_SET_MULTIPLEX_RATIO);
-	_sh1106_i2c_send_byte_function(0x3F);
-
-	//SET ENTIRE DISPLAY = ON
-	_sh1106_i2c_send_byte_function(SH1106_I2C_CMD_SET_ENTIRE_DISPLAY_ON);
-
-	//SET DISPLAY OFFSET = 0
-	_sh1106_i2c_send_byte_function(SH1106_I2C_CMD_SET_DISPLAY_OFFSET_MODE);
-	_sh1106_i2c_send_byte_function(0x00);
-
-	//SET DISPLAY OSCILLATOR FREQUENCY
-	_sh1106_i2c_send_byte_function(SH1106_I2C_CMD_SET_OSCILLATOR_FREQUENCY);
-	_sh1106_i2c_send_byte_function(0xF0);
-
-	//SET DISCHARGE-PRECHARGE PERIOD
-	_sh1106_i2c_send_byte_function(SH1106_I2C_CMD_SET_DISCHARGE_PRECHARGE);
-	_sh1106_i2c_send_byte_function(0x22);
-
-	//SET COMMON PADS HARDWARE CONFIG
-	_sh1106_i2c_send_byte_function(SH1106_I2C_CMD_COMMON_PADS_HARDWARE_CONFIG);
-	_sh1106_i2c_send_byte_function(0x12);
-
-	//SET COMMON PAD OUTPUT VOLTAGE
-	_sh1106_i2c_send_byte_function(SH1106_I2C_CMD_COMMON_PADS_OUTPUT_VOLTAGE);
-	_sh1106_i2c_send_byte_function(0x20);
-
-	_sh1106_i2c_send_byte_function(0x8D);
-	_sh1106_i2c_send_byte_function(0x14);
-
-	//SET DISPLAY ON
-	_sh1106_i2c_send_byte_function(SH1106_I2C_CMD_SET_DISPLAY_ON);
+	if(!_sh1106_i2c_send_init_commands())
+	{
+		if(_sh1106_i2c_debug)
+		{
+			debug_printf("SH1106 : Display init NACKed\n");
+		}
+		return 0;
+	}
 
-	_sh1106_i2c_send_stop_function();
+	//THE DISPLAY RAM IS NOT CLEARED BY THE INIT STREAM
+	_sh1106_i2c_ram_out_of_sync = 1;
 
 	if(_sh1106_i2c_debug)
 	{
 		debug_printf("SH1106 : Frame buffer allocated\n");
 		debug_printf("SH1106 : Display initialized\n");
 	}
+	return 1;
 }
 
-void PUT_FUNCTION_IN_FLASH SH1106_I2C_SetDisplayOnOff(uint8_t on)
+uint8_t PUT_FUNCTION_IN_FLASH SH1106_I2C_SetDisplayOnOff(uint8_t on)
 {
 	//TURN THE DISPLAY ON/OFF DEPENDING ON INPUT ARGUENT VALUE
+	//RETURNS 1 IF ACKED (THE DRIVER STATE ONLY CHANGES THEN)
 
-	_sh1106_i2c_send_start_function();
+	_sh1106_i2c_transaction_start();
 
 	//SET I2C SLAVE WRITE ADDRESS
-	_sh1106_i2c_send_byte_function((_sh1106_i2c_slave_address << 1));
+	_sh1106_i2c_transaction_send((_sh1106_i2c_slave_address << 1));
 
 	//SET TYPE TO COMMAND STREAM
-	_sh1106_i2c_send_byte_function(SH1106_I2C_CONTROL_BYTE_CMD_STREAM);
+	_sh1106_i2c_transaction_send(SH1106_I2C_CONTROL_BYTE_CMD_STREAM);
 
 	if(on)
 	{
-		_sh1106_i2c_send_byte_function(SH1106_I2C_CMD_SET_DISPLAY_ON);
-		if(_sh1106_i2c_debug)
-		{
-			debug_printf("SH1106 : Display turned ON\n");
-		}
+		_sh1106_i2c_transaction_send(SH1106_I2C_CMD_SET_DISPLAY_ON);
 	}
 	else
 	{
-		_sh1106_i2c_send_byte_function(SH1106_I2C_CMD_SET_DISPLAY_OFF);
-		if(_sh1106_i2c_debug)
-		{
-			debug_printf("SH1106 : Display turned OFF\n");
-		}
+		_sh1106_i2c_transaction_send(SH1106_I2C_CMD_SET_DISPLAY_OFF);
 	}
-	_sh1106_i2c_send_stop_function();
+	if(!_sh1106_i2c_transaction_stop())
+	{
+		return 0;
+	}
+
+	_sh1106_i2c_display_on = (on != 0);
+	if(_sh1106_i2c_debug)
+	{
+		debug_printf("SH1106 : Display turned %s\n", on ? "ON" : "OFF");
+	}
+	return 1;
 }
 
-void PUT_FUNCTION_IN_FLASH SH1106_I2C_SetDisplayContrast(uint8_t contrast_val)
+uint8_t PUT_FUNCTION_IN_FLASH SH1106_I2C_SetDisplayContrast(uint8_t contrast_val)
 {
 	//SET THE CONTRAST OF THE DISPLAY (0 - 255)
 	//HIGHER THE CONTRAST, HIGHER THE DISPLAY CURRENT CONSUMPTION
+	//RETURNS 1 IF ACKED (THE DRIVER STATE ONLY CHANGES THEN)
 
-	_sh1106_i2c_send_start_function();
+	_sh1106_i2c_transaction_start();
 
 	//SET I2C SLAVE WRITE ADDRESS
-	_sh1106_i2c_send_byte_function((_sh1106_i2c_slave_address << 1));
+	_sh1106_i2c_transaction_send((_sh1106_i2c_slave_address << 1));
 
 	//SET TYPE TO COMMAND STREAM
-	_sh1106_i2c_send_byte_function(SH1106_I2C_CONTROL_BYTE_CMD_STREAM);
+	_sh1106_i2c_transaction_send(SH1106_I2C_CONTROL_BYTE_CMD_STREAM);
 
-	_sh1106_i2c_send_byte_function(SH1106_I2C_CMD_SET_CONTRAST_CONTROL_MODE);
-	_sh1106_i2c_send_byte_function(contrast_val);
+	_sh1106_i2c_transaction_send(SH1106_I2C_CMD_SET_CONTRAST_CONTROL_MODE);
+	_sh1106_i2c_transaction_send(contrast_val);
+	if(!_sh1106_i2c_transaction_stop())
+	{
+		return 0;
+	}
 
+	_sh1106_i2c_contrast = contrast_val;
 	if(_sh1106_i2c_debug)
 	{
 		debug_printf("SH1106 : Contrast set to : %u\n", contrast_val);
 	}
-	_sh1106_i2c_send_stop_function();
+	return 1;
 }
 
-void PUT_FUNCTION_IN_FLASH SH1106_I2C_SetDisplayNormal(void)
+uint8_t PUT_FUNCTION_IN_FLASH SH1106_I2C_SetDisplayNormal(void)
 {
 	//SET DISPLAY TO NORMAL MODE
+	//RETURNS 1 IF ACKED (THE DRIVER STATE ONLY CHANGES THEN)
 
-	_sh1106_i2c_send_start_function();
+	_sh1106_i2c_transaction_start();
 
 	//SET I2C SLAVE WRITE ADDRESS
-	_sh1106_i2c_send_byte_function((_sh1106_i2c_slave_address << 1));
+	_sh1106_i2c_transaction_send((_sh1106_i2c_slave_address << 1));
 
 	//SET TYPE TO COMMAND STREAM
-	_sh1106_i2c_send_byte_function(SH1106_I2C_CONTROL_BYTE_CMD_STREAM);
+	_sh1106_i2c_transaction_send(SH1106_I2C_CONTROL_BYTE_CMD_STREAM);
+
+	_sh1106_i2c_transaction_send(SH1106_I2C_CMD_SET_DISPLAY_NORMAL);
+	if(!_sh1106_i2c_transaction_stop())
+	{
+		return 0;
+	}
 
-	_sh1106_i2c_send_byte_function(SH1106_I2C_CMD_SET_DISPLAY_NORMAL);
+	_sh1106_i2c_inverted = 0;
 	if(_sh1106_i2c_debug)
 	{
 		debug_printf("SH1106 : Display = Normal\n");
 	}
-
-	_sh1106_i2c_send_stop_function();
+	return 1;
 }
 
-void PUT_FUNCTION_IN_FLASH SH1106_I2C_SetDisplayInverted(void)
+uint8_t PUT_FUNCTION_IN_FLASH SH1106_I2C_SetDisplayInverted(void)
 {
 	//SET DISPLAY TO INVERTED MODE
+	//RETURNS 1 IF ACKED (THE DRIVER STATE ONLY CHANGES THEN)
 
-	_sh1106_i2c_send_start_function();
+	_sh1106_i2c_transaction_start();
 
 	//SET I2C SLAVE WRITE ADDRESS
-	_sh1106_i2c_send_byte_function((_sh1106_i2c_slave_address << 1));
+	_sh1106_i2c_transaction_send((_sh1106_i2c_slave_address << 1));
 
 	//SET TYPE TO COMMAND STREAM
-	_sh1106_i2c_send_byte_function(SH1106_I2C_CONTROL_BYTE_CMD_STREAM);
+	_sh1106_i2c_transaction_send(SH1106_I2C_CONTROL_BYTE_CMD_STREAM);
+
+	_sh1106_i2c_transaction_send(SH1106_I2C_CMD_SET_DISPLAY_REVERSED);
+	if(!_sh1106_i2c_transaction_stop())
+	{
+		return 0;
+	}
 
-	_sh1106_i2c_send_byte_function(SH1106_I2C_CMD_SET_DISPLAY_REVERSED);
+	_sh1106_i2c_inverted = 1;
 	if(_sh1106_i2c_debug)
 	{
 		debug_printf("SH1106 : Display = Inverted\n");
 	}
+	return 1;
+}
 
-	_sh1106_i2c_send_stop_function();
+uint8_t PUT_FUNCTION_IN_FLASH SH1106_I2C_SetOrientation(uint8_t orientation)
+{
+	//SET THE DISPLAY ORIENTATION BY REPROGRAMMING THE SEGMENT REMAP AND COM SCAN DIRECTION
+	//NO SOFTWARE TRANSFORM OF THE FRAMEBUFFER IS NEEDED. WHEN FLIPPED HORIZONTALLY THE OLED
+	//IS SEEN FROM THE OTHER END OF THE 132 COLUMN RAM, SO THE COLUMN OFFSET IS MIRRORED TOO
+	//THE WHOLE SCREEN IS ONLY INVALIDATED IF THAT MOVES THE RAM WINDOW. WITHOUT A FRAMEBUFFER
+	//(DIRECT MODE) THERE IS NOTHING TO RESEND, SO THE DISPLAY RAM IS CLEARED INSTEAD OF SHOWING
+	//THE OLD CONTENT SHIFTED BY THE OFFSET. REDRAW IT AFTERWARDS
+	//RETURNS 1 IF ACKED. IF NOT, THE DRIVER KEEPS THE OLD ORIENTATION AND COLUMN OFFSET
+	//SO IT STILL MATCHES THE PANEL
+
+	uint8_t old_column_offset = _sh1106_i2c_column_offset;
+
+	orientation &= SH1106_I2C_ORIENTATION_ROTATE_180;
+
+	_sh1106_i2c_transaction_start();
+
+	//SET I2C SLAVE WRITE ADDRESS
+	_sh1106_i2c_transaction_send((_sh1106_i2c_slave_address << 1));
+
+	//SET TYPE TO COMMAND STREAM
+	_sh1106_i2c_transaction_send(SH1106_I2C_CONTROL_BYTE_CMD_STREAM);
+
+	_sh1106_i2c_transaction_send(SH1106_I2C_CMD_SET_SEGMENT_REMAP | ((orientation & SH1106_I2C_ORIENTATION_FLIP_HORIZONTAL) ? 0 : 1));
+	_sh1106_i2c_transaction_send(SH1106_I2C_CMD_SET_COMMON_SCAN_DIRECTION | ((orientation & SH1106_I2C_ORIENTATION_FLIP_VERTICAL) ? 0 : 8));
+
+	if(!_sh1106_i2c_transaction_stop())
+	{
+		return 0;
+	}
+
+	_sh1106_i2c_orientation = orientation;
+	_sh1106_i2c_update_column_offset();
+
+	if(_sh1106_i2c_column_offset != old_column_offset)
+	{
+		if(_sh1106_framebuffer_pointer != NULL)
+		{
+			SH1106_I2C_InvalidateAll(SH1106_I2C_INVALIDATE_DEFERRED);
+		}
+		else if(!_sh1106_i2c_clear_display_ram())
+		{
+			return 0;
+		}
+	}
+
+	if(_sh1106_i2c_debug)
+	{
+		debug_printf("SH1106 : Orientation set to %u\n", _sh1106_i2c_orientation);
+	}
+	return 1;
 }
 
 void PUT_FUNCTION_IN_FLASH SH1106_I2C_ResetAndClearScreen(const uint8_t* fill_pattern, uint8_t pattern_len)
@@ -287,7 +422,7 @@ void PUT_FUNCTION_IN_FLASH SH1106_I2C_ResetAndClearScreen(const uint8_t* fill_pa
 			{
 				color = 0;
 			}
-			for(i = 0; i < 16; i++)
+			for(i = 0; i < ((SH1106_I2C_OLED_MAX_COLUMN + 1) / 8); i++)
 			{
 				SH1106_I2C_DrawPixel(x_offset + (8 * i), y_offset, color);
 			}
@@ -301,7 +436,7 @@ void PUT_FUNCTION_IN_FLASH SH1106_I2C_ResetAndClearScreen(const uint8_t* fill_pa
 			{
 				color = 0;
 			}
-			for(i = 0; i < 16; i++)
+			for(i = 0; i < ((SH1106_I2C_OLED_MAX_COLUMN + 1) / 8); i++)
 			{
 				SH1106_I2C_DrawPixel(x_offset + (8 * i), y_offset, color);
 			}
@@ -315,7 +450,7 @@ void PUT_FUNCTION_IN_FLASH SH1106_I2C_ResetAndClearScreen(const uint8_t* fill_pa
 			{
 				color = 0;
 			}
-			for(i = 0; i < 16; i++)
+			for(i = 0; i < ((SH1106_I2C_OLED_MAX_COLUMN + 1) / 8); i++)
 			{
 				SH1106_I2C_DrawPixel(x_offset + (8 * i), y_offset, color);
 			}
@@ -329,7 +464,7 @@ void PUT_FUNCTION_IN_FLASH SH1106_I2C_ResetAndClearScreen(const uint8_t* fill_pa
 			{
 				color = 0;
 			}
-			for(i = 0; i < 16; i++)
+			for(i = 0; i < ((SH1106_I2C_OLED_MAX_COLUMN + 1) / 8); i++)
 			{
 				SH1106_I2C_DrawPixel(x_offset + (8 * i), y_offset, color);
 			}
@@ -343,7 +478,7 @@ void PUT_FUNCTION_IN_FLASH SH1106_I2C_ResetAndClearScreen(const uint8_t* fill_pa
 			{
 				color = 0;
 			}
-			for(i = 0; i < 16; i++)
+			for(i = 0; i < ((SH1106_I2C_OLED_MAX_COLUMN + 1) / 8); i++)
 			{
 				SH1106_I2C_DrawPixel(x_offset + (8 * i), y_offset, color);
 			}
@@ -357,7 +492,7 @@ void PUT_FUNCTION_IN_FLASH SH1106_I2C_ResetAndClearScreen(const uint8_t* fill_pa
 			{
 				color = 0;
 			}
-			for(i = 0; i < 16; i++)
+			for(i = 0; i < ((SH1106_I2C_OLED_MAX_COLUMN + 1) / 8); i++)
 			{
 				SH1106_I2C_DrawPixel(x_offset + (8 * i), y_offset, color);
 			}
@@ -371,7 +506,7 @@ void PUT_FUNCTION_IN_FLASH SH1106_I2C_ResetAndClearScreen(const uint8_t* fill_pa
 			{
 				color = 0;
 			}
-			for(i = 0; i < 16; i++)
+			for(i = 0; i < ((SH1106_I2C_OLED_MAX_COLUMN + 1) / 8); i++)
 			{
 				SH1106_I2C_DrawPixel(x_offset + (8 * i), y_offset, color);
 			}
@@ -385,7 +520,7 @@ void PUT_FUNCTION_IN_FLASH SH1106_I2C_ResetAndClearScreen(const uint8_t* fill_pa
 			{
 				color = 0;
 			}
-			for(i = 0; i < 16; i++)
+			for(i = 0; i < ((SH1106_I2C_OLED_MAX_COLUMN + 1) / 8); i++)
 			{
 				SH1106_I2C_DrawPixel(x_offset + (8 * i), y_offset, color);
 			}
@@ -406,37 +541,46 @@ void PUT_FUNCTION_IN_FLASH SH1106_I2C_ResetAndClearScreen(const uint8_t* fill_pa
 void PUT_FUNCTION_IN_FLASH SH1106_I2C_UpdateDisplay(void)
 {
 	//TRANSFER THE FRAMEBUFFER TO THE DISPLAY IN BULK
+	//IF THE REFRESH SCHEDULER IS RUNNING, THE REQUEST IS ONLY QUEUED AND
+	//COALESCED WITH THE OTHER REQUESTS OF THE CURRENT FRAME
+	//IN GRAY MODE BOTH BIT PLANES ARE SENT (SH1106_I2C_GrayUpdate) INSTEAD
+	//DOES NOTHING WITHOUT A FRAMEBUFFER (DIRECT MODE)
 
-	uint16_t counter = 0;
-	uint16_t x = 0;
 	uint16_t y = 0;
 
-	for(y = 0; y < (SH1106_I2C_OLED_MAX_PAGE + 1); y++)
+	if(_sh1106_framebuffer_pointer == NULL)
 	{
-		//SET CURSOR TO THE BEGINNING OF THE CURRENT PAGE
-		_sh1106_i2c_send_start_function();
-		_sh1106_i2c_send_byte_function((_sh1106_i2c_slave_address << 1));
-		_sh1106_i2c_send_byte_function(SH1106_I2C_CONTROL_BYTE_CMD_STREAM);
+		return;
+	}
 
-		//SET COLUMN TO 2
-		_sh1106_i2c_send_byte_function(SH1106_I2C_CMD_SET_COLUMN_UPPER_4);
-		_sh1106_i2c_send_byte_function(SH1106_I2C_CMD_SET_COLUMN_LOWER_4 | 0);
+	if(_sh1106_i2c_gray_lsb_plane != NULL)
+	{
+		SH1106_I2C_GrayUpdate();
+		return;
+	}
 
-		//SET PAGE
-		_sh1106_i2c_send_byte_function(SH1106_I2C_CMD_SET_PAGE_ADDRESS | y);
-		_sh1106_i2c_send_stop_function();
+	if(_sh1106_i2c_scheduler_running)
+	{
+		SH1106_I2C_InvalidateAll(SH1106_I2C_INVALIDATE_DEFERRED);
+		return;
+	}
 
-		//SEND PAGE DATA
-		_sh1106_i2c_send_start_function();
-		_sh1106_i2c_send_byte_function((_sh1106_i2c_slave_address << 1));
-		_sh1106_i2c_send_byte_function(SH1106_I2C_CONTROL_BYTE_DATA_STREAM);
+	//EVERY PAGE IS EITHER SENT OR LEFT DIRTY BELOW
+	_sh1106_i2c_ram_out_of_sync = 0;
 
-		for(x = 0; x < (SH1106_I2C_OLED_MAX_COLUMN + 1); x++)
+	for(y = 0; y < (SH1106_I2C_OLED_MAX_PAGE + 1); y++)
+	{
+		if(_sh1106_i2c_send_page_span(y, 0, SH1106_I2C_OLED_MAX_COLUMN))
+		{
+			_sh1106_i2c_dirty_page_mask &= ~(1 << y);
+		}
+		else
 		{
-			_sh1106_i2c_send_byte_function(_sh1106_framebuffer_pointer[counter]);
-			counter++;
+			//LEAVE ONLY THIS PAGE PENDING FOR THE NEXT FLUSH
+			_sh1106_i2c_dirty_page_mask |= (1 << y);
+			_sh1106_i2c_dirty_column_start[y] = 0;
+			_sh1106_i2c_dirty_column_end[y] = SH1106_I2C_OLED_MAX_COLUMN;
 		}
-		_sh1106_i2c_send_stop_function();
 	}
 
 	if(_sh1106_i2c_debug)
@@ -445,368 +589,2933 @@ void PUT_FUNCTION_IN_FLASH SH1106_I2C_UpdateDisplay(void)
 	}
 }
 
-void PUT_FUNCTION_IN_FLASH SH1106_I2C_DrawPixel(uint8_t x, uint8_t y, uint8_t color)
+void PUT_FUNCTION_IN_FLASH SH1106_I2C_PrepareDeepSleep(uint8_t display_off)
 {
-	//SET OR UNSET A PIXEL AT THE SPECIFIED X,Y LOCATION
-
-	if((x > SH1106_I2C_OLED_MAX_COLUMN) || (y > (SH1106_I2C_OLED_MAX_PAGE * 8 + 7)))
+	//SAVE THE CONTROLLER STATE AND FRAMEBUFFER CHECKSUMS TO RTC MEMORY BEFORE DEEP SLEEP
+	//SO THAT SH1106_I2C_WarmResume() CAN SKIP THE FULL INIT AND CLEAR ON WAKE UP
+	//THE CHECKSUMS MUST DESCRIBE THE DISPLAY RAM, SO GRAY MODE IS STOPPED AND THE PENDING DIRTY
+	//AREA IS FLUSHED FIRST. THE WHOLE FRAMEBUFFER IS ONLY RESENT IF THE DISPLAY RAM IS OUT OF
+	//SYNC IN A WAY THE DIRTY AREA DOES NOT COVER (EG A STREAMED FRAME)
+	//A PAGE THAT FAILS TO GO THROUGH IS RECORDED WITH CHECKSUMS THAT FORCE IT OUT ON RESUME
+	//WITHOUT A FRAMEBUFFER (DIRECT MODE) NO RECORD IS KEPT AND THE RESUME FALLS BACK TO INIT
+	//IF display_off IS SET THE DISPLAY IS TURNED OFF FOR THE SLEEP (IT IS STILL
+	//RECORDED AS ON, SO THE RESUME TURNS IT BACK ON)
+
+	uint8_t page;
+	uint8_t segment;
+
+	if(_sh1106_framebuffer_pointer == NULL)
 	{
-		//PIXEL OUT OF RANGE
-		if(_sh1106_i2c_debug)
+		_sh1106_i2c_resume_record.magic = 0;
+		system_rtc_mem_write(SH1106_I2C_RESUME_RTC_MEM_BLOCK, &_sh1106_i2c_resume_record, sizeof(_sh1106_i2c_resume_record.magic));
+		if(display_off && _sh1106_i2c_display_on)
 		{
-			debug_printf("SH1106 : Drawpixel out of range\n");
+			SH1106_I2C_SetDisplayOnOff(0);
 		}
 		return;
 	}
 
-	//PIXEL IN RANGE
-	if(!color)
+	SH1106_I2C_GrayStop();
+	if(_sh1106_i2c_ram_out_of_sync)
 	{
-		//CLEAR PIXEL
-		_sh1106_framebuffer_pointer[((y/8) * 128) + x] &= ~(1 << (y%8));
+		SH1106_I2C_InvalidateAll(SH1106_I2C_INVALIDATE_DEFERRED);
 	}
-	else
+	SH1106_I2C_FlushDirty();
+
+	_sh1106_i2c_resume_record.magic = SH1106_I2C_RESUME_MAGIC;
+	_sh1106_i2c_resume_record.slave_address = _sh1106_i2c_slave_address;
+	_sh1106_i2c_resume_record.contrast = _sh1106_i2c_contrast;
+	_sh1106_i2c_resume_record.orientation = _sh1106_i2c_orientation;
+	_sh1106_i2c_resume_record.flags = (_sh1106_i2c_display_on ? SH1106_I2C_RESUME_FLAG_DISPLAY_ON : 0) |
+										(_sh1106_i2c_inverted ? SH1106_I2C_RESUME_FLAG_INVERTED : 0);
+
+	for(page = 0; page < (SH1106_I2C_OLED_MAX_PAGE + 1); page++)
 	{
-		//DRAW PIXEL
-		_sh1106_framebuffer_pointer[((y/8) * 128) + x] |= (1 << (y%8));
+		for(segment = 0; segment < SH1106_I2C_RESUME_SEGMENTS; segment++)
+		{
+			_sh1106_i2c_resume_record.checksum[page][segment] = _sh1106_i2c_checksum(&_sh1106_framebuffer_pointer[(page * (SH1106_I2C_OLED_MAX_COLUMN + 1)) + (segment * SH1106_I2C_RESUME_SEGMENT_COLUMNS)], SH1106_I2C_RESUME_SEGMENT_COLUMNS);
+			if(_sh1106_i2c_suspect_page_mask & (1 << page))
+			{
+				//DISPLAY RAM OF THIS PAGE IS UNKNOWN
+				_sh1106_i2c_resume_record.checksum[page][segment] = ~_sh1106_i2c_resume_record.checksum[page][segment];
+			}
+		}
 	}
-}
 
-void PUT_FUNCTION_IN_FLASH SH1106_I2C_DrawLineVertical(uint8_t x, uint8_t y_start, uint8_t y_end, uint8_t color)
-{
-	//DRAW A VERTICAL LINE
+	system_rtc_mem_write(SH1106_I2C_RESUME_RTC_MEM_BLOCK, &_sh1106_i2c_resume_record, sizeof(SH1106_I2C_RESUME_RECORD));
 
-	uint8_t counter = y_start;
-	while(counter <= y_end)
+	if(display_off && _sh1106_i2c_display_on)
 	{
-		SH1106_I2C_DrawPixel(x, counter, color);
-		counter += 1;
+		SH1106_I2C_SetDisplayOnOff(0);
 	}
 
 	if(_sh1106_i2c_debug)
 	{
-		debug_printf("SH1106 : Drawline vertical\n");
+		debug_printf("SH1106 : Resume record saved\n");
 	}
 }
 
-void PUT_FUNCTION_IN_FLASH SH1106_I2C_DrawLineHorizontal(uint8_t x_start, uint8_t x_end, uint8_t y, uint8_t color)
+uint8_t PUT_FUNCTION_IN_FLASH SH1106_I2C_WarmResume(void)
 {
-	//DRAW A HORIZONTAL LINE
+	//RESUME THE DISPLAY AFTER DEEP SLEEP FROM THE RECORD SAVED BY SH1106_I2C_PrepareDeepSleep()
+	//INSTEAD OF SH1106_I2C_Init(). SH1106_I2C_SetDeviceAddress() MUST BE CALLED FIRST
+	//NO INIT STREAM AND NO CLEAR IS SENT. ONLY THE DISPLAY ON COMMAND IF THE DISPLAY WAS ON
+	//THE FRAMEBUFFER STARTS BLANK. REDRAW IT AND CALL SH1106_I2C_ResumeFlush() TO SEND
+	//ONLY WHAT CHANGED WHILE ASLEEP
+	//RETURNS 1 IF RESUMED, 0 IF THERE IS NO VALID RECORD OR THE DISPLAY ON COMMAND WAS
+	//NACKED (CALL SH1106_I2C_Init() INSTEAD)
 
-	uint8_t counter = x_start;
-	while(counter <= x_end)
-	{
-		SH1106_I2C_DrawPixel(counter, y, color);
-		counter += 1;
-	}
+	system_rtc_mem_read(SH1106_I2C_RESUME_RTC_MEM_BLOCK, &_sh1106_i2c_resume_record, sizeof(SH1106_I2C_RESUME_RECORD));
 
-	if(_sh1106_i2c_debug)
+	if((_sh1106_i2c_resume_record.magic != SH1106_I2C_RESUME_MAGIC) || (_sh1106_i2c_resume_record.slave_address != _sh1106_i2c_slave_address))
 	{
-		debug_printf("SH1106 : Drawline horizontal\n");
+		if(_sh1106_i2c_debug)
+		{
+			debug_printf("SH1106 : No valid resume record\n");
+		}
+		return 0;
 	}
-}
-
-void PUT_FUNCTION_IN_FLASH SH1106_I2C_DrawBoxEmpty(uint8_t x_start, uint8_t y_start, uint8_t x_end, uint8_t y_end, uint8_t color)
-{
-	//DRAW EMPTY RECTANGLE BETWEEN THE SPECIFIED COORDINATES
 
-	SH1106_I2C_DrawLineHorizontal(x_start, x_end, y_start, color);
-	SH1106_I2C_DrawLineHorizontal(x_start, x_end, y_end, color);
-	SH1106_I2C_DrawLineVertical(x_start, y_start, y_end, color);
-	SH1106_I2C_DrawLineVertical(x_end, y_start, y_end, color);
+	//THE RECORD IS ONLY GOOD FOR ONE WAKE UP
+	_sh1106_i2c_resume_record.magic = 0;
+	system_rtc_mem_write(SH1106_I2C_RESUME_RTC_MEM_BLOCK, &_sh1106_i2c_resume_record, sizeof(_sh1106_i2c_resume_record.magic));
 
-	if(_sh1106_i2c_debug)
+	if(_sh1106_framebuffer_pointer == NULL)
 	{
-		debug_printf("SH1106 : Drawbox empty\n");
+		_sh1106_framebuffer_pointer = (uint8_t*)os_zalloc((SH1106_I2C_OLED_MAX_COLUMN + 1) * (SH1106_I2C_OLED_MAX_PAGE + 1));
+		if(_sh1106_framebuffer_pointer == NULL)
+		{
+			return 0;
+		}
 	}
-}
-
-void PUT_FUNCTION_IN_FLASH SH1106_I2C_DrawBoxFilled(uint8_t x_start, uint8_t y_start, uint8_t x_end, uint8_t y_end, uint8_t color)
-{
-	//DRAW FILLED RECTANGLE BETWEEN THE SPECIFIED COORDINATES
 
-	uint8_t counter = y_start;
+	_sh1106_i2c_contrast = _sh1106_i2c_resume_record.contrast;
+	_sh1106_i2c_orientation = _sh1106_i2c_resume_record.orientation;
+	_sh1106_i2c_inverted = (_sh1106_i2c_resume_record.flags & SH1106_I2C_RESUME_FLAG_INVERTED) ? 1 : 0;
+	_sh1106_i2c_display_on = (_sh1106_i2c_resume_record.flags & SH1106_I2C_RESUME_FLAG_DISPLAY_ON) ? 1 : 0;
+	_sh1106_i2c_update_column_offset();
 
-	while(counter <= y_end)
+	if(_sh1106_i2c_display_on && !SH1106_I2C_SetDisplayOnOff(1))
 	{
-		SH1106_I2C_DrawLineHorizontal(x_start, x_end, counter, color);
-		counter += 1;
+		//THE RECORD IS ALREADY USED UP, SO THE CALLER FALLS BACK TO SH1106_I2C_Init()
+		if(_sh1106_i2c_debug)
+		{
+			debug_printf("SH1106 : Warm resume display on NACKed\n");
+		}
+		return 0;
 	}
+	_sh1106_i2c_resume_pending = 1;
+	_sh1106_i2c_ram_out_of_sync = 1;
 
 	if(_sh1106_i2c_debug)
 	{
-		debug_printf("SH1106 : Drawbox filled\n");
+		debug_printf("SH1106 : Display warm resumed\n");
 	}
+	return 1;
 }
 
-void PUT_FUNCTION_IN_FLASH SH1106_I2C_DrawCircleEmpty(int8_t x, int8_t y, int8_t radius, uint8_t color)
+uint8_t PUT_FUNCTION_IN_FLASH SH1106_I2C_ResumeFlush(void)
 {
-	//DRAW CIRCLE OUTLINE AT SPECIFIED CORDINATE WITH SPECIFIED RADIUS
+	//AFTER A WARM RESUME, SEND ONLY THE FRAMEBUFFER SEGMENTS WHOSE CHECKSUM DIFFERS
+	//FROM THE ONE SAVED BEFORE SLEEP (THE REST IS STILL IN THE DISPLAY RAM)
+	//RETURNS THE NUMBER OF SEGMENTS SENT
 
-	int16_t curr_x, curr_y;
-	int16_t compare = radius * radius;
-	int16_t compare_1 = (radius + 1) * (radius + 1);
+	uint8_t page;
+	uint8_t segment;
+	uint8_t changed = 0;
+	uint8_t x_start;
 
-	for(curr_y = -radius; curr_y <= radius; curr_y++)
+	if(!_sh1106_i2c_resume_pending)
 	{
-		for(curr_x = -radius; curr_x <= radius; curr_x++)
+		return 0;
+	}
+
+	for(page = 0; page < (SH1106_I2C_OLED_MAX_PAGE + 1); page++)
+	{
+		for(segment = 0; segment < SH1106_I2C_RESUME_SEGMENTS; segment++)
 		{
-			if(((curr_x * curr_x) + (curr_y * curr_y)) < compare)
-			{
-				//DO NOTHING
-			}
-			else if(((curr_x * curr_x) + (curr_y * curr_y)) < compare_1)
+			x_start = segment * SH1106_I2C_RESUME_SEGMENT_COLUMNS;
+			if(_sh1106_i2c_checksum(&_sh1106_framebuffer_pointer[(page * (SH1106_I2C_OLED_MAX_COLUMN + 1)) + x_start], SH1106_I2C_RESUME_SEGMENT_COLUMNS) != _sh1106_i2c_resume_record.checksum[page][segment])
 			{
-				SH1106_I2C_DrawPixel(x + curr_x, y + curr_y, color);
+				SH1106_I2C_Invalidate(x_start, (page * 8), (x_start + SH1106_I2C_RESUME_SEGMENT_COLUMNS - 1), ((page * 8) + 7), SH1106_I2C_INVALIDATE_DEFERRED);
+				changed++;
 			}
 		}
 	}
+	//EVERY SEGMENT THAT DIFFERS IS NOW DIRTY
+	_sh1106_i2c_ram_out_of_sync = 0;
+	SH1106_I2C_FlushDirty();
+	_sh1106_i2c_resume_pending = 0;
 
 	if(_sh1106_i2c_debug)
 	{
-		debug_printf("SH1106 : Drawcircle empty\n");
+		debug_printf("SH1106 : Resume flush sent %u segments\n", changed);
 	}
+	return changed;
 }
-void PUT_FUNCTION_IN_FLASH SH1106_I2C_DrawCircleFilled(int8_t x, int8_t y, int8_t radius, uint8_t color)
+
+void PUT_FUNCTION_IN_FLASH SH1106_I2C_SchedulerStart(uint16_t frame_interval_ms)
 {
-	int16_t curr_x, curr_y;
-	int16_t compare = radius * radius;
+	//START THE REFRESH SCHEDULER
+	//INVALIDATE REQUESTS ARE COALESCED AND THE DIRTY AREA IS FLUSHED AT MOST
+	//ONCE EVERY frame_interval_ms (0 = SH1106_I2C_SCHEDULER_DEFAULT_FRAME_INTERVAL_MS)
 
-	for(curr_y = -radius; curr_y <= radius; curr_y++)
+	if(frame_interval_ms == 0)
 	{
-		for(curr_x = -radius; curr_x <= radius; curr_x++)
-		{
-			if(((curr_x * curr_x) + (curr_y * curr_y)) <= compare)
-			{
-				SH1106_I2C_DrawPixel(x + curr_x, y + curr_y, color);
-			}
-		}
+		frame_interval_ms = SH1106_I2C_SCHEDULER_DEFAULT_FRAME_INTERVAL_MS;
 	}
 
+	os_timer_disarm(&_sh1106_i2c_scheduler_timer);
+	os_timer_setfn(&_sh1106_i2c_scheduler_timer, (os_timer_func_t*)_sh1106_i2c_scheduler_timer_cb, NULL);
+	os_timer_arm(&_sh1106_i2c_scheduler_timer, frame_interval_ms, 1);
+	_sh1106_i2c_scheduler_running = 1;
+
 	if(_sh1106_i2c_debug)
 	{
-		debug_printf("SH1106 : Drawcircle filled\n");
+		debug_printf("SH1106 : Scheduler started with frame interval %u ms\n", frame_interval_ms);
 	}
 }
 
-void PUT_FUNCTION_IN_FLASH SH1106_I2C_DrawString(char* str, uint8_t x, uint8_t y, const FONT_INFO font, uint8_t color)
+void PUT_FUNCTION_IN_FLASH SH1106_I2C_SchedulerStop(void)
 {
-	//DRAW THE SPECIFIED TEXT STRING AT THE GIVEN LOCATION WITH THE SPECIFIED FONT AND COLOR
+	//STOP THE REFRESH SCHEDULER
+	//ANY PENDING DIRTY AREA IS FLUSHED SO NOTHING IS LOST
 
-	uint16_t counter_char;
-	uint16_t x_offset = x;
-	uint16_t y_offset = y;
-	uint16_t length = strlen(str);
+	os_timer_disarm(&_sh1106_i2c_scheduler_timer);
+	_sh1106_i2c_scheduler_running = 0;
 
-	os_printf("string len = %u\n", length);
+	SH1106_I2C_FlushDirty();
 
-	uint16_t i;
+	if(_sh1106_i2c_debug)
+	{
+		debug_printf("SH1106 : Scheduler stopped\n");
+	}
+}
 
-	//GET FONT HEGHT
-	//ONLY FONTS WITH COMMON HEIGHT SUPPORTED
-	uint16_t font_height_bits = font.font_char_descriptors[0][1];
-	uint16_t char_width_bytes;
-	uint16_t current_char;
+void PUT_FUNCTION_IN_FLASH SH1106_I2C_Invalidate(uint8_t x_start, uint8_t y_start, uint8_t x_end, uint8_t y_end, uint8_t urgent)
+{
+	//MARK THE SPECIFIED RECTANGLE OF THE FRAMEBUFFER AS NEEDING A FLUSH
+	//WITH THE SCHEDULER RUNNING THE FLUSH HAPPENS ON THE NEXT FRAME TICK,
+	//UNLESS urgent IS SET IN WHICH CASE ALL PENDING AREA IS FLUSHED NOW
+	//WITHOUT THE SCHEDULER RUNNING, THE AREA STAYS PENDING UNTIL SH1106_I2C_FlushDirty()
+
+	uint8_t page;
+	uint8_t page_start;
+	uint8_t page_end;
+	uint8_t was_pending;
+	uint8_t new_area = 0;
+
+	if((x_start > x_end) || (y_start > y_end) || (x_start > SH1106_I2C_OLED_MAX_COLUMN) || (y_start > (SH1106_I2C_OLED_MAX_PAGE * 8 + 7)))
+	{
+		//NOTHING ON SCREEN TO INVALIDATE
+		return;
+	}
 
-	for(counter_char = 0; counter_char < length; counter_char++)
+	//CLIP TO SCREEN
+	if(x_end > SH1106_I2C_OLED_MAX_COLUMN)
+	{
+		x_end = SH1106_I2C_OLED_MAX_COLUMN;
+	}
+	if(y_end > (SH1106_I2C_OLED_MAX_PAGE * 8 + 7))
 	{
-		y_offset = y;
-		os_printf("current char = %c", str[counter_char]);
-		os_printf(" pos = %u,%u\n", x_offset, y_offset);
+		y_end = (SH1106_I2C_OLED_MAX_PAGE * 8 + 7);
+	}
 
-		current_char = str[counter_char];
+	_sh1106_i2c_scheduler_stats.invalidate_requests++;
+	was_pending = (_sh1106_i2c_dirty_page_mask != 0);
 
-		if(current_char < font.start_char || current_char > font.end_char)
+	page_start = y_start / 8;
+	page_end = y_end / 8;
+
+	for(page = page_start; page <= page_end; page++)
+	{
+		if(!(_sh1106_i2c_dirty_page_mask & (1 << page)))
 		{
-			//CHARACTER IS NOT SUPPORTED BY SPECIFIED FONT
-			//DRAW A BLOCK 8 BITS WIDE AND HEIGHT OF THE FONT IN CHARACTERS PLACE
+			_sh1106_i2c_dirty_page_mask |= (1 << page);
+			_sh1106_i2c_dirty_column_start[page] = x_start;
+			_sh1106_i2c_dirty_column_end[page] = x_end;
+			new_area = 1;
+			continue;
+		}
 
-			while(y_offset < font_height_bits)
-			{
-				SH1106_I2C_DrawLineHorizontal(x_offset, x_offset + 7, y_offset, color);
-				y_offset += 1;
-			}
-			x_offset += 8;
+		//PAGE ALREADY PENDING. GROW ITS SPAN IF REQUIRED
+		if(x_start < _sh1106_i2c_dirty_column_start[page])
+		{
+			_sh1106_i2c_dirty_column_start[page] = x_start;
+			new_area = 1;
 		}
-		else
+		if(x_end > _sh1106_i2c_dirty_column_end[page])
 		{
-			//CHARACTER SUPPORTED BY THE FONT
-
-			char_width_bytes = (font.font_char_descriptors[current_char - font.start_char][0]);
+			_sh1106_i2c_dirty_column_end[page] = x_end;
+			new_area = 1;
+		}
+	}
 
-			while(y_offset < (y + font_height_bits))
-			{
-				for(i = 0; i < char_width_bytes; i++)
-				{
-					uint8_t byte = font.font_bitmap[font.font_char_descriptors[current_char - font.start_char][2] + (char_width_bytes * (y_offset - y)) + i];
+	if(!new_area && !urgent)
+	{
+		//ALREADY FULLY COVERED BY THE PENDING FLUSH
+		//(AN URGENT REQUEST STILL SENDS THAT FLUSH NOW SO IT IS NOT DROPPED)
+		_sh1106_i2c_scheduler_stats.dropped_updates++;
+	}
+	else if(was_pending)
+	{
+		_sh1106_i2c_scheduler_stats.merged_updates++;
+	}
 
-					if(byte & 0x80)
-					{
-						SH1106_I2C_DrawPixel(x_offset, y_offset, color);
-					}
-					x_offset++;
-					if(byte & 0x40)
-					{
-						SH1106_I2C_DrawPixel(x_offset, y_offset, color);
-					}
-					x_offset++;
-					if(byte & 0x20)
-					{
-						SH1106_I2C_DrawPixel(x_offset, y_offset, color);
-					}
-					x_offset++;
-					if(byte & 0x10)
-					{
-						SH1106_I2C_DrawPixel(x_offset, y_offset, color);
-					}
-					x_offset++;
-					if(byte & 0x08)
-					{
-						SH1106_I2C_DrawPixel(x_offset, y_offset, color);
-					}
-					x_offset++;
-					if(byte & 0x04)
-					{
-						SH1106_I2C_DrawPixel(x_offset, y_offset, color);
-					}
-					x_offset++;
-					if(byte & 0x02)
-					{
-						SH1106_I2C_DrawPixel(x_offset, y_offset, color);
-					}
-					x_offset++;
-					if(byte & 0x01)
-					{
-						SH1106_I2C_DrawPixel(x_offset, y_offset, color);
-					}
+	if(urgent)
+	{
+		if(_sh1106_i2c_dirty_page_mask != 0)
+		{
+			_sh1106_i2c_scheduler_stats.urgent_flushes++;
+		}
+		SH1106_I2C_FlushDirty();
+	}
+}
+
+void PUT_FUNCTION_IN_FLASH SH1106_I2C_InvalidateAll(uint8_t urgent)
+{
+	//MARK THE WHOLE FRAMEBUFFER AS NEEDING A FLUSH
+	//THE DIRTY AREA THEN COVERS ANY WAY THE DISPLAY RAM WAS OUT OF SYNC
+
+	_sh1106_i2c_ram_out_of_sync = 0;
+	SH1106_I2C_Invalidate(0, 0, SH1106_I2C_OLED_MAX_COLUMN, (SH1106_I2C_OLED_MAX_PAGE * 8 + 7), urgent);
+}
+
+void PUT_FUNCTION_IN_FLASH SH1106_I2C_FlushDirty(void)
+{
+	//SEND ONLY THE PENDING DIRTY COLUMN SPANS OF EACH PAGE TO THE DISPLAY
+	//IN GRAY MODE THE DISPLAY IS PUT BACK ON THE MSB PLANE FIRST, THEN THE DIRTY SPANS ARE SENT
+	//AND THE GRAY SPANS WORKED OUT AGAIN FOR THE FLUSHED PAGES ONLY (ALSO ON SCHEDULER TICKS)
+
+	uint8_t page;
+	uint8_t flushed_pages;
+
+	if(_sh1106_i2c_dirty_page_mask == 0)
+	{
+		return;
+	}
+
+	if(_sh1106_framebuffer_pointer == NULL)
+	{
+		//NOTHING TO SEND WITHOUT A FRAMEBUFFER (DIRECT MODE)
+		_sh1106_i2c_dirty_page_mask = 0;
+		return;
+	}
+
+	if(_sh1106_i2c_gray_lsb_plane != NULL)
+	{
+		os_timer_disarm(&_sh1106_i2c_gray_timer);
+		if(_sh1106_i2c_gray_plane)
+		{
+			if(!_sh1106_i2c_gray_show_plane(0))
+			{
+				//TRY AGAIN ON THE NEXT FLUSH AND KEEP ALTERNATING MEANWHILE
+				if(!_sh1106_i2c_gray_degraded)
+				{
+					_sh1106_i2c_gray_arm();
+				}
+				return;
+			}
+			_sh1106_i2c_gray_plane = 0;
+		}
+	}
+	flushed_pages = _sh1106_i2c_dirty_page_mask;
+
+	for(page = 0; page < (SH1106_I2C_OLED_MAX_PAGE + 1); page++)
+	{
+		if(_sh1106_i2c_dirty_page_mask & (1 << page))
+		{
+			//A PAGE THAT FAILED TO GO THROUGH STAYS DIRTY (AND SUSPECT) FOR THE NEXT FLUSH
+			if(_sh1106_i2c_send_page_span(page, _sh1106_i2c_dirty_column_start[page], _sh1106_i2c_dirty_column_end[page]))
+			{
+				_sh1106_i2c_dirty_page_mask &= ~(1 << page);
+			}
+		}
+	}
+
+	if(_sh1106_i2c_gray_lsb_plane != NULL)
+	{
+		for(page = 0; page < (SH1106_I2C_OLED_MAX_PAGE + 1); page++)
+		{
+			if(flushed_pages & (1 << page))
+			{
+				_sh1106_i2c_gray_scan_page(page);
+			}
+		}
+		//A DISPLAY THAT FELL BACK TO 1 BIT STAYS SO UNTIL THE NEXT SH1106_I2C_GrayUpdate
+		if(!_sh1106_i2c_gray_degraded)
+		{
+			_sh1106_i2c_gray_arm();
+		}
+	}
+
+	if(_sh1106_i2c_debug)
+	{
+		debug_printf("SH1106 : Dirty area flushed\n");
+	}
+}
+
+void PUT_FUNCTION_IN_FLASH SH1106_I2C_SchedulerGetStats(SH1106_I2C_SCHEDULER_STATS* stats)
+{
+	//COPY OUT THE REFRESH SCHEDULER STATISTICS
+
+	os_memcpy(stats, &_sh1106_i2c_scheduler_stats, sizeof(SH1106_I2C_SCHEDULER_STATS));
+}
+
+void PUT_FUNCTION_IN_FLASH SH1106_I2C_SchedulerResetStats(void)
+{
+	//RESET THE REFRESH SCHEDULER STATISTICS
+
+	os_memset(&_sh1106_i2c_scheduler_stats, 0, sizeof(SH1106_I2C_SCHEDULER_STATS));
+}
+
+void PUT_FUNCTION_IN_FLASH SH1106_I2C_TransportGetStats(SH1106_I2C_TRANSPORT_STATS* stats)
+{
+	//COPY OUT THE I2C TRANSPORT ERROR AND RETRY STATISTICS
+
+	os_memcpy(stats, &_sh1106_i2c_transport_stats, sizeof(SH1106_I2C_TRANSPORT_STATS));
+}
+
+void PUT_FUNCTION_IN_FLASH SH1106_I2C_TransportResetStats(void)
+{
+	//RESET THE I2C TRANSPORT ERROR AND RETRY STATISTICS
+
+	os_memset(&_sh1106_i2c_transport_stats, 0, sizeof(SH1106_I2C_TRANSPORT_STATS));
+}
+
+uint8_t PUT_FUNCTION_IN_FLASH SH1106_I2C_GetSuspectPages(void)
+{
+	//RETURN THE MASK OF PAGES (BIT n = PAGE n) WHOSE LAST TRANSFER FAILED
+	//THEY ARE STILL DIRTY AND GO OUT AGAIN ON THE NEXT FLUSH
+
+	return _sh1106_i2c_suspect_page_mask;
+}
+
+uint8_t PUT_FUNCTION_IN_FLASH SH1106_I2C_SendCommands(const uint8_t* commands, uint8_t command_count)
+{
+	//SEND RAW COMMANDS AS ONE ACK CHECKED COMMAND STREAM TRANSACTION
+	//NO DRIVER STATE IS UPDATED. RETURNS 1 IF EVERY BYTE WAS ACKED
+
+	uint8_t i;
+
+	_sh1106_i2c_transaction_start();
+	_sh1106_i2c_transaction_send((_sh1106_i2c_slave_address << 1));
+	_sh1106_i2c_transaction_send(SH1106_I2C_CONTROL_BYTE_CMD_STREAM);
+	for(i = 0; i < command_count; i++)
+	{
+		_sh1106_i2c_transaction_send(commands[i]);
+	}
+	return _sh1106_i2c_transaction_stop();
+}
+
+uint8_t PUT_FUNCTION_IN_FLASH SH1106_I2C_SendPageData(uint8_t page, uint8_t ram_column, const uint8_t* data, uint16_t len)
+{
+	//SEND len BYTES TO THE DISPLAY RAM FROM ram_column (0 - 131, NO COLUMN OFFSET APPLIED)
+	//OF THE SPECIFIED PAGE, WITH THE PER PAGE RETRIES OF THE FRAMEBUFFER PATH
+	//RETURNS 1 ON SUCCESS, 0 IF THE PAGE STILL FAILED AFTER ITS RETRIES
+
+	_sh1106_i2c_ram_out_of_sync = 1;
+	return _sh1106_i2c_send_ram_data(page, ram_column, data, len);
+}
+
+void PUT_FUNCTION_IN_FLASH SH1106_I2C_EffectClear(void)
+{
+	//STOP ANY RUNNING EFFECT AND EMPTY THE EFFECT SCHEDULE
+
+	SH1106_I2C_EffectStop();
+	_sh1106_i2c_effect_step_count = 0;
+}
+
+uint8_t PUT_FUNCTION_IN_FLASH SH1106_I2C_EffectAppendStep(const uint8_t* commands, uint8_t command_count, uint16_t delay_ms)
+{
+	//APPEND A STEP OF RAW DISPLAY COMMANDS TO THE EFFECT SCHEDULE
+	//RETURNS 1 IF APPENDED, 0 IF THE SCHEDULE IS FULL OR THE STEP TOO LONG
+
+	SH1106_I2C_EFFECT_STEP* step;
+
+	if((_sh1106_i2c_effect_step_count >= SH1106_I2C_EFFECT_MAX_STEPS) || (command_count > SH1106_I2C_EFFECT_MAX_STEP_COMMANDS))
+	{
+		if(_sh1106_i2c_debug)
+		{
+			debug_printf("SH1106 : Effect schedule full\n");
+		}
+		return 0;
+	}
+
+	step = &_sh1106_i2c_effect_steps[_sh1106_i2c_effect_step_count];
+	step->command_count = command_count;
+	os_memcpy(step->commands, commands, command_count);
+	step->delay_ms = delay_ms;
+	_sh1106_i2c_effect_step_count++;
+
+	return 1;
+}
+
+uint8_t PUT_FUNCTION_IN_FLASH SH1106_I2C_EffectAppendFade(uint8_t contrast_from, uint8_t contrast_to, uint8_t steps, uint16_t step_ms)
+{
+	//APPEND A LINEAR CONTRAST RAMP FROM contrast_from TO contrast_to IN THE SPECIFIED NUMBER OF STEPS
+	//ALL CONTRAST VALUES ARE WORKED OUT HERE SO THE TIMER ONLY SENDS THEM
+
+	uint8_t commands[2];
+	uint8_t start_count = _sh1106_i2c_effect_step_count;
+	uint8_t i;
+
+	commands[0] = SH1106_I2C_CMD_SET_CONTRAST_CONTROL_MODE;
+
+	for(i = 1; i <= steps; i++)
+	{
+		commands[1] = (uint8_t)((int16_t)contrast_from + ((((int16_t)contrast_to - (int16_t)contrast_from) * i) / steps));
+		if(!SH1106_I2C_EffectAppendStep(commands, 2, step_ms))
+		{
+			//DO NOT LEAVE A HALF BUILT FADE IN THE SCHEDULE
+			_sh1106_i2c_effect_step_count = start_count;
+			return 0;
+		}
+	}
+	return 1;
+}
+
+uint8_t PUT_FUNCTION_IN_FLASH SH1106_I2C_EffectAppendBlink(uint8_t count, uint16_t period_ms)
+{
+	//APPEND count INVERT BLINKS (INVERTED FOR HALF THE PERIOD, NORMAL FOR THE OTHER HALF)
+
+	uint8_t inverted = SH1106_I2C_CMD_SET_DISPLAY_REVERSED;
+	uint8_t normal = SH1106_I2C_CMD_SET_DISPLAY_NORMAL;
+	uint8_t start_count = _sh1106_i2c_effect_step_count;
+	uint8_t i;
+
+	for(i = 0; i < count; i++)
+	{
+		if(!SH1106_I2C_EffectAppendStep(&inverted, 1, period_ms / 2) ||
+			!SH1106_I2C_EffectAppendStep(&normal, 1, period_ms - (period_ms / 2)))
+		{
+			//DO NOT LEAVE A HALF BUILT BLINK IN THE SCHEDULE
+			_sh1106_i2c_effect_step_count = start_count;
+			return 0;
+		}
+	}
+	return 1;
+}
+
+uint8_t PUT_FUNCTION_IN_FLASH SH1106_I2C_EffectAppendPulse(uint8_t count, uint16_t on_ms, uint16_t off_ms)
+{
+	//APPEND count DISPLAY OFF/ON PULSES
+
+	uint8_t off = SH1106_I2C_CMD_SET_DISPLAY_OFF;
+	uint8_t on = SH1106_I2C_CMD_SET_DISPLAY_ON;
+	uint8_t start_count = _sh1106_i2c_effect_step_count;
+	uint8_t i;
+
+	for(i = 0; i < count; i++)
+	{
+		if(!SH1106_I2C_EffectAppendStep(&off, 1, off_ms) ||
+			!SH1106_I2C_EffectAppendStep(&on, 1, on_ms))
+		{
+			//DO NOT LEAVE A HALF BUILT PULSE IN THE SCHEDULE
+			_sh1106_i2c_effect_step_count = start_count;
+			return 0;
+		}
+	}
+	return 1;
+}
+
+uint16_t PUT_FUNCTION_IN_FLASH SH1106_I2C_EffectGetBusBytes(void)
+{
+	//RETURN THE NUMBER OF BYTES ONE PASS OF THE EFFECT SCHEDULE PUTS ON THE I2C BUS
+	//EACH TRANSACTION COSTS ADDRESS + CONTROL BYTE + COMMANDS. STEPS WITH 0 DELAY
+	//ARE BATCHED INTO THE TRANSACTION OF THE FOLLOWING STEP
+
+	uint16_t bytes = 0;
+	uint8_t i;
+	uint8_t in_transaction = 0;
+
+	for(i = 0; i < _sh1106_i2c_effect_step_count; i++)
+	{
+		if(!in_transaction)
+		{
+			bytes += 2;
+			in_transaction = 1;
+		}
+		bytes += _sh1106_i2c_effect_steps[i].command_count;
+		if(_sh1106_i2c_effect_steps[i].delay_ms != 0)
+		{
+			in_transaction = 0;
+		}
+	}
+	return bytes;
+}
+
+void PUT_FUNCTION_IN_FLASH SH1106_I2C_EffectStart(uint8_t repeat, SH1106_I2C_EFFECT_DONE_CALLBACK done_cb)
+{
+	//START PLAYING THE EFFECT SCHEDULE FROM THE FIRST STEP
+	//IF repeat IS SET THE SCHEDULE LOOPS UNTIL SH1106_I2C_EffectStop()
+	//OTHERWISE done_cb (IF NOT NULL) IS CALLED AFTER THE LAST STEP
+
+	if(_sh1106_i2c_effect_step_count == 0)
+	{
+		return;
+	}
+
+	os_timer_disarm(&_sh1106_i2c_effect_timer);
+	os_timer_setfn(&_sh1106_i2c_effect_timer, (os_timer_func_t*)_sh1106_i2c_effect_timer_cb, NULL);
+
+	_sh1106_i2c_effect_step_index = 0;
+	_sh1106_i2c_effect_repeat = repeat;
+	_sh1106_i2c_effect_done_cb = done_cb;
+	_sh1106_i2c_effect_running = 1;
+
+	if(_sh1106_i2c_debug)
+	{
+		debug_printf("SH1106 : Effect started (%u steps, %u bus bytes)\n", _sh1106_i2c_effect_step_count, SH1106_I2C_EffectGetBusBytes());
+	}
+
+	//FIRST STEP GOES OUT RIGHT AWAY
+	_sh1106_i2c_effect_timer_cb(NULL);
+}
+
+void PUT_FUNCTION_IN_FLASH SH1106_I2C_EffectStop(void)
+{
+	//STOP THE RUNNING EFFECT. THE DISPLAY IS LEFT IN WHATEVER STATE THE LAST STEP SET
+
+	os_timer_disarm(&_sh1106_i2c_effect_timer);
+	_sh1106_i2c_effect_running = 0;
+}
+
+uint8_t PUT_FUNCTION_IN_FLASH SH1106_I2C_EffectIsRunning(void)
+{
+	//RETURN 1 IF AN EFFECT IS PLAYING
+
+	return _sh1106_i2c_effect_running;
+}
+
+void PUT_FUNCTION_IN_FLASH SH1106_I2C_DrawPixel(uint8_t x, uint8_t y, uint8_t color)
+{
+	//SET OR UNSET A PIXEL AT THE SPECIFIED X,Y LOCATION
+	//DOES NOTHING WITHOUT A FRAMEBUFFER (DIRECT MODE, SEE SH1106_I2C_DirectDrawPixel)
+
+	if(_sh1106_framebuffer_pointer == NULL)
+	{
+		return;
+	}
+
+	if((x > SH1106_I2C_OLED_MAX_COLUMN) || (y > (SH1106_I2C_OLED_MAX_PAGE * 8 + 7)))
+	{
+		//PIXEL OUT OF RANGE
+		if(_sh1106_i2c_debug)
+		{
+			debug_printf("SH1106 : Drawpixel out of range\n");
+		}
+		return;
+	}
+
+	//PIXEL IN RANGE
+	if(!color)
+	{
+		//CLEAR PIXEL
+		_sh1106_framebuffer_pointer[((y >> 3) * (SH1106_I2C_OLED_MAX_COLUMN + 1)) + x] &= ~(1 << (y & 7));
+	}
+	else
+	{
+		//DRAW PIXEL
+		_sh1106_framebuffer_pointer[((y >> 3) * (SH1106_I2C_OLED_MAX_COLUMN + 1)) + x] |= (1 << (y & 7));
+	}
+}
+
+void PUT_FUNCTION_IN_FLASH SH1106_I2C_DrawLineVertical(uint8_t x, uint8_t y_start, uint8_t y_end, uint8_t color)
+{
+	//DRAW A VERTICAL LINE
+
+	uint8_t counter = y_start;
+	while(counter <= y_end)
+	{
+		SH1106_I2C_DrawPixel(x, counter, color);
+		counter += 1;
+	}
+
+	if(_sh1106_i2c_debug)
+	{
+		debug_printf("SH1106 : Drawline vertical\n");
+	}
+}
+
+void PUT_FUNCTION_IN_FLASH SH1106_I2C_DrawLineHorizontal(uint8_t x_start, uint8_t x_end, uint8_t y, uint8_t color)
+{
+	//DRAW A HORIZONTAL LINE
+
+	uint8_t counter = x_start;
+	while(counter <= x_end)
+	{
+		SH1106_I2C_DrawPixel(counter, y, color);
+		counter += 1;
+	}
+
+	if(_sh1106_i2c_debug)
+	{
+		debug_printf("SH1106 : Drawline horizontal\n");
+	}
+}
+
+void PUT_FUNCTION_IN_FLASH SH1106_I2C_DrawBoxEmpty(uint8_t x_start, uint8_t y_start, uint8_t x_end, uint8_t y_end, uint8_t color)
+{
+	//DRAW EMPTY RECTANGLE BETWEEN THE SPECIFIED COORDINATES
+
+	SH1106_I2C_DrawLineHorizontal(x_start, x_end, y_start, color);
+	SH1106_I2C_DrawLineHorizontal(x_start, x_end, y_end, color);
+	SH1106_I2C_DrawLineVertical(x_start, y_start, y_end, color);
+	SH1106_I2C_DrawLineVertical(x_end, y_start, y_end, color);
+
+	if(_sh1106_i2c_debug)
+	{
+		debug_printf("SH1106 : Drawbox empty\n");
+	}
+}
+
+void PUT_FUNCTION_IN_FLASH SH1106_I2C_DrawBoxFilled(uint8_t x_start, uint8_t y_start, uint8_t x_end, uint8_t y_end, uint8_t color)
+{
+	//DRAW FILLED RECTANGLE BETWEEN THE SPECIFIED COORDINATES
+
+	uint8_t counter = y_start;
+
+	while(counter <= y_end)
+	{
+		SH1106_I2C_DrawLineHorizontal(x_start, x_end, counter, color);
+		counter += 1;
+	}
+
+	if(_sh1106_i2c_debug)
+	{
+		debug_printf("SH1106 : Drawbox filled\n");
+	}
+}
+
+void PUT_FUNCTION_IN_FLASH SH1106_I2C_DrawCircleEmpty(int8_t x, int8_t y, int8_t radius, uint8_t color)
+{
+	//DRAW CIRCLE OUTLINE AT SPECIFIED CORDINATE WITH SPECIFIED RADIUS
+
+	int16_t curr_x, curr_y;
+	int16_t compare = radius * radius;
+	int16_t compare_1 = (radius + 1) * (radius + 1);
+
+	for(curr_y = -radius; curr_y <= radius; curr_y++)
+	{
+		for(curr_x = -radius; curr_x <= radius; curr_x++)
+		{
+			if(((curr_x * curr_x) + (curr_y * curr_y)) < compare)
+			{
+				//DO NOTHING
+			}
+			else if(((curr_x * curr_x) + (curr_y * curr_y)) < compare_1)
+			{
+				SH1106_I2C_DrawPixel(x + curr_x, y + curr_y, color);
+			}
+		}
+	}
+
+	if(_sh1106_i2c_debug)
+	{
+		debug_printf("SH1106 : Drawcircle empty\n");
+	}
+}
+void PUT_FUNCTION_IN_FLASH SH1106_I2C_DrawCircleFilled(int8_t x, int8_t y, int8_t radius, uint8_t color)
+{
+	int16_t curr_x, curr_y;
+	int16_t compare = radius * radius;
+
+	for(curr_y = -radius; curr_y <= radius; curr_y++)
+	{
+		for(curr_x = -radius; curr_x <= radius; curr_x++)
+		{
+			if(((curr_x * curr_x) + (curr_y * curr_y)) <= compare)
+			{
+				SH1106_I2C_DrawPixel(x + curr_x, y + curr_y, color);
+			}
+		}
+	}
+
+	if(_sh1106_i2c_debug)
+	{
+		debug_printf("SH1106 : Drawcircle filled\n");
+	}
+}
+
+#ifdef SH1106_I2C_DIRECT_MODE
+uint8_t PUT_FUNCTION_IN_FLASH SH1106_I2C_DirectInit(void)
+{
+	//INITIALIZE THE OLED MODULE FOR DIRECT MODE
+	//NO FRAMEBUFFER IS ALLOCATED. THE DISPLAY RAM IS CLEARED INSTEAD SINCE
+	//IT HOLDS RANDOM DATA AT POWER UP
+	//RETURNS 1 IF EVERY TRANSACTION WAS ACKED
+
+	uint8_t result;
+
+	result = _sh1106_i2c_send_init_commands();
+	if(!_sh1106_i2c_clear_display_ram())
+	{
+		result = 0;
+	}
+
+	if(_sh1106_i2c_debug)
+	{
+		debug_printf("SH1106 : Display initialized (direct mode)%s\n", result ? "" : " with NACKs");
+	}
+	return result;
+}
+
+uint8_t PUT_FUNCTION_IN_FLASH SH1106_I2C_DirectDrawPixel(uint8_t x, uint8_t y, uint8_t color)
+{
+	//SET OR UNSET A PIXEL DIRECTLY IN THE DISPLAY RAM
+	//RETURNS 1 ON SUCCESS, 0 IF OUT OF RANGE OR THE BUS FAILED
+
+	if((x > SH1106_I2C_OLED_MAX_COLUMN) || (y > (SH1106_I2C_OLED_MAX_PAGE * 8 + 7)))
+	{
+		//PIXEL OUT OF RANGE
+		if(_sh1106_i2c_debug)
+		{
+			debug_printf("SH1106 : Direct drawpixel out of range\n");
+		}
+		return 0;
+	}
+
+	return _sh1106_i2c_direct_update_span(y >> 3, x, x, (1 << (y & 7)), color);
+}
+
+uint8_t PUT_FUNCTION_IN_FLASH SH1106_I2C_DirectDrawLineHorizontal(uint8_t x_start, uint8_t x_end, uint8_t y, uint8_t color)
+{
+	//DRAW A HORIZONTAL LINE DIRECTLY IN THE DISPLAY RAM
+
+	return SH1106_I2C_DirectDrawBoxFilled(x_start, y, x_end, y, color);
+}
+
+uint8_t PUT_FUNCTION_IN_FLASH SH1106_I2C_DirectDrawLineVertical(uint8_t x, uint8_t y_start, uint8_t y_end, uint8_t color)
+{
+	//DRAW A VERTICAL LINE DIRECTLY IN THE DISPLAY RAM
+
+	return SH1106_I2C_DirectDrawBoxFilled(x, y_start, x, y_end, color);
+}
+
+uint8_t PUT_FUNCTION_IN_FLASH SH1106_I2C_DirectDrawBoxFilled(uint8_t x_start, uint8_t y_start, uint8_t x_end, uint8_t y_end, uint8_t color)
+{
+	//DRAW FILLED RECTANGLE DIRECTLY IN THE DISPLAY RAM
+	//PAGES THE BOX ONLY PARTLY COVERS ARE READ-MODIFY-WRITTEN, FULLY COVERED PAGES ARE JUST WRITTEN
+	//RETURNS 1 ON SUCCESS. A PAGE THAT FAILS DOES NOT STOP THE OTHER PAGES FROM BEING DRAWN
+
+	uint8_t page;
+	uint8_t mask;
+	uint8_t result = 1;
+
+	if((x_start > x_end) || (y_start > y_end) || (x_start > SH1106_I2C_OLED_MAX_COLUMN) || (y_start > (SH1106_I2C_OLED_MAX_PAGE * 8 + 7)))
+	{
+		return 0;
+	}
+	if(x_end > SH1106_I2C_OLED_MAX_COLUMN)
+	{
+		x_end = SH1106_I2C_OLED_MAX_COLUMN;
+	}
+	if(y_end > (SH1106_I2C_OLED_MAX_PAGE * 8 + 7))
+	{
+		y_end = (SH1106_I2C_OLED_MAX_PAGE * 8 + 7);
+	}
+
+	for(page = (y_start >> 3); page <= (y_end >> 3); page++)
+	{
+		//ROWS OF THIS PAGE INSIDE THE BOX
+		mask = 0xFF;
+		if(page == (y_start >> 3))
+		{
+			mask &= (0xFF << (y_start & 7));
+		}
+		if(page == (y_end >> 3))
+		{
+			mask &= (0xFF >> (7 - (y_end & 7)));
+		}
+		if(!_sh1106_i2c_direct_update_span(page, x_start, x_end, mask, color))
+		{
+			result = 0;
+		}
+	}
+	return result;
+}
+
+void PUT_FUNCTION_IN_FLASH SH1106_I2C_DirectGetStats(SH1106_I2C_DIRECT_STATS* stats)
+{
+	//COPY OUT THE DIRECT MODE BUS STATISTICS
+
+	os_memcpy(stats, &_sh1106_i2c_direct_stats, sizeof(SH1106_I2C_DIRECT_STATS));
+}
+
+void PUT_FUNCTION_IN_FLASH SH1106_I2C_DirectResetStats(void)
+{
+	//RESET THE DIRECT MODE BUS STATISTICS
+
+	os_memset(&_sh1106_i2c_direct_stats, 0, sizeof(SH1106_I2C_DIRECT_STATS));
+}
+#endif
+
+uint8_t PUT_FUNCTION_IN_FLASH SH1106_I2C_StreamFrame(const uint8_t* frame)
+{
+	//SEND A CALLER OWNED FRAME STRAIGHT TO THE DISPLAY
+	//FRAME MUST BE IN THE DISPLAY PAGE MAJOR FORMAT ((MAX_PAGE + 1) PAGES OF (MAX_COLUMN + 1) BYTES)
+	//THE FRAMEBUFFER IS NOT USED OR UPDATED
+	//RETURNS 1 IF EVERY PAGE WENT THROUGH, 0 IF A PAGE FAILED AFTER ITS RETRIES
+
+	uint8_t page;
+	uint8_t ok = 1;
+
+	_sh1106_i2c_ram_out_of_sync = 1;
+
+	for(page = 0; page < (SH1106_I2C_OLED_MAX_PAGE + 1); page++)
+	{
+		if(!_sh1106_i2c_send_page_data(page, 0, &frame[page * (SH1106_I2C_OLED_MAX_COLUMN + 1)], (SH1106_I2C_OLED_MAX_COLUMN + 1)))
+		{
+			ok = 0;
+		}
+	}
+
+	if(_sh1106_i2c_debug)
+	{
+		debug_printf("SH1106 : Frame streamed\n");
+	}
+	return ok;
+}
+
+uint8_t PUT_FUNCTION_IN_FLASH SH1106_I2C_StreamFromProducer(SH1106_I2C_STREAM_PRODUCER producer, void* arg)
+{
+	//SEND A FRAME TO THE DISPLAY PAGE BY PAGE AS THE PRODUCER YIELDS IT
+	//THE PRODUCER RETURNS A POINTER TO ITS OWN PAGE DATA (NO COPY), WHICH ONLY NEEDS TO
+	//STAY VALID UNTIL THE NEXT CALL. THE FRAMEBUFFER IS NOT USED OR UPDATED
+	//A PRODUCER RETURNING NULL ABORTS THE REST OF THE FRAME
+	//RETURNS 1 IF EVERY PAGE PRODUCED WENT THROUGH, 0 IF A PAGE FAILED AFTER ITS RETRIES
+
+	const uint8_t* page_data;
+	uint8_t page;
+	uint8_t ok = 1;
+
+	_sh1106_i2c_ram_out_of_sync = 1;
+
+	for(page = 0; page < (SH1106_I2C_OLED_MAX_PAGE + 1); page++)
+	{
+		page_data = producer(page, arg);
+		if(page_data == NULL)
+		{
+			//PRODUCER ABORTED THE FRAME
+			break;
+		}
+		if(!_sh1106_i2c_send_page_data(page, 0, page_data, (SH1106_I2C_OLED_MAX_COLUMN + 1)))
+		{
+			ok = 0;
+		}
+	}
+
+	if(_sh1106_i2c_debug)
+	{
+		debug_printf("SH1106 : Frame streamed from producer (%u pages)\n", page);
+	}
+	return ok;
+}
+
+uint8_t PUT_FUNCTION_IN_FLASH SH1106_I2C_ImageImport(const uint8_t* image, uint16_t width, uint16_t height, uint16_t stride, uint8_t bytes_per_pixel, uint8_t mode, uint8_t threshold, uint8_t* dest, uint16_t dest_width)
+{
+	//CONVERT AN 8 BIT GRAY (OR 24 BIT RGB) ROW MAJOR IMAGE TO 1 BIT, WRITING THE DISPLAY
+	//PAGE MAJOR FORMAT STRAIGHT INTO dest (dest_width BYTES PER PAGE, (height + 7) / 8 PAGES)
+	//stride IS THE NUMBER OF BYTES BETWEEN IMAGE ROWS
+	//A PIXEL IS LIT WHEN BRIGHTER THAN threshold (THRESHOLD AND FLOYD-STEINBERG MODES)
+	//IN ORDERED MODE threshold BIASES THE BAYER MATRIX (128 = NO BIAS)
+	//RETURNS 1 ON SUCCESS, 0 IF THE WORKING BUFFERS COULD NOT BE ALLOCATED
+
+	uint8_t result = _sh1106_i2c_image_import_frames(&image, 1, width, height, stride, bytes_per_pixel, mode, threshold, dest, dest_width);
+
+	if(_sh1106_i2c_debug)
+	{
+		debug_printf("SH1106 : Image imported (%ux%u, mode %u)\n", width, height, mode);
+	}
+	return result;
+}
+
+uint8_t PUT_FUNCTION_IN_FLASH SH1106_I2C_ImageImportToFramebuffer(const uint8_t* image, uint16_t width, uint16_t height, uint16_t stride, uint8_t bytes_per_pixel, uint8_t mode, uint8_t threshold)
+{
+	//IMPORT AN IMAGE (SEE SH1106_I2C_ImageImport) STRAIGHT INTO THE FRAMEBUFFER AT 0,0
+	//THE IMAGE IS CLIPPED TO THE SCREEN. IT IS NOT SENT UNTIL THE NEXT UPDATE / FLUSH
+	//IF THE HEIGHT IS NOT A MULTIPLE OF 8, THE FRAMEBUFFER ROWS BELOW THE IMAGE IN ITS
+	//LAST PAGE ARE KEPT
+	//RETURNS 0 WITHOUT A FRAMEBUFFER (DIRECT MODE) OR IF THE IMPORT FAILED
+
+	uint8_t saved[SH1106_I2C_OLED_MAX_COLUMN + 1];
+	uint8_t* last_page;
+	uint8_t mask;
+	uint8_t result;
+	uint16_t x;
+
+	if(_sh1106_framebuffer_pointer == NULL)
+	{
+		return 0;
+	}
+
+	if(width > (SH1106_I2C_OLED_MAX_COLUMN + 1))
+	{
+		width = (SH1106_I2C_OLED_MAX_COLUMN + 1);
+	}
+	if(height > ((SH1106_I2C_OLED_MAX_PAGE + 1) * 8))
+	{
+		height = ((SH1106_I2C_OLED_MAX_PAGE + 1) * 8);
+	}
+	if((width == 0) || (height == 0))
+	{
+		return 1;
+	}
+
+	last_page = &_sh1106_framebuffer_pointer[((height - 1) >> 3) * (SH1106_I2C_OLED_MAX_COLUMN + 1)];
+	mask = (uint8_t)((1 << (height & 7)) - 1);
+	if(mask)
+	{
+		os_memcpy(saved, last_page, width);
+	}
+
+	result = SH1106_I2C_ImageImport(image, width, height, stride, bytes_per_pixel, mode, threshold, _sh1106_framebuffer_pointer, (SH1106_I2C_OLED_MAX_COLUMN + 1));
+
+	if(mask)
+	{
+		//READ-MODIFY-WRITE THE PARTIAL LAST PAGE
+		for(x = 0; x < width; x++)
+		{
+			last_page[x] = (last_page[x] & mask) | (saved[x] & ~mask);
+		}
+	}
+	return result;
+}
+
+uint8_t PUT_FUNCTION_IN_FLASH SH1106_I2C_ImageImportSequence(const uint8_t* const* frames, uint16_t frame_count, uint16_t width, uint16_t height, uint16_t stride, uint8_t bytes_per_pixel, uint8_t mode, uint8_t threshold, uint8_t* dest)
+{
+	//IMPORT frame_count IMAGES OF THE SAME FORMAT (SEE SH1106_I2C_ImageImport) INTO dest
+	//AS CONSECUTIVE PAGE MAJOR FRAMES OF width * ((height + 7) / 8) BYTES EACH
+	//THE WORKING BUFFERS ARE ALLOCATED ONCE FOR THE WHOLE SEQUENCE
+	//RETURNS 1 ON SUCCESS, 0 IF THE WORKING BUFFERS COULD NOT BE ALLOCATED
+
+	uint8_t result = _sh1106_i2c_image_import_frames(frames, frame_count, width, height, stride, bytes_per_pixel, mode, threshold, dest, width);
+
+	if(_sh1106_i2c_debug)
+	{
+		debug_printf("SH1106 : Image sequence imported (%u frames)\n", frame_count);
+	}
+	return result;
+}
+
+uint16_t PUT_FUNCTION_IN_FLASH SH1106_I2C_MeasureString(const char* str, const FONT_INFO font)
+{
+	//RETURN THE WIDTH IN PIXELS OF THE WIDEST LINE OF THE STRING IN THE SPECIFIED FONT
+	//NOTHING IS DRAWN
+
+	const uint8_t* advance_table = _sh1106_i2c_font_advance_table(&font);
+	uint16_t width = 0;
+	uint16_t max_width = 0;
+
+	while(*str)
+	{
+		if(*str == '\n')
+		{
+			width = 0;
+		}
+		else
+		{
+			width += _sh1106_i2c_char_advance(advance_table, &font, (uint8_t)*str);
+			if(width > max_width)
+			{
+				max_width = width;
+			}
+		}
+		str++;
+	}
+	return max_width;
+}
+
+uint8_t PUT_FUNCTION_IN_FLASH SH1106_I2C_LayoutText(const char* str, const FONT_INFO font, uint8_t box_width, uint8_t max_lines, uint8_t flags, SH1106_I2C_TEXT_SPAN* spans)
+{
+	//BREAK THE STRING INTO LINES FITTING box_width AND FILL IN ONE SPAN PER LINE
+	//(AT MOST max_lines). NOTHING IS DRAWN
+	//SH1106_I2C_TEXT_WRAP		: WRAP AT SPACES (OR MID WORD IF A WORD DOES NOT FIT A LINE)
+	//SH1106_I2C_TEXT_ELLIPSIS	: TRUNCATE OVERFLOWING LINES / TEXT WITH "..."
+	//WITHOUT WRAP, LINES ONLY BREAK AT '\n' AND OVERFLOWING LINES ARE CLIPPED
+	//RETURNS THE NUMBER OF LINES
+
+	const uint8_t* advance_table = _sh1106_i2c_font_advance_table(&font);
+	uint8_t dot_advance = _sh1106_i2c_char_advance(advance_table, &font, '.');
+	uint8_t lines = 0;
+	uint8_t align = flags & SH1106_I2C_TEXT_ALIGN_MASK;
+	uint8_t wrapped;
+	uint8_t spaces;
+	uint8_t advance;
+	uint16_t pos = 0;
+	uint16_t i;
+	uint16_t width;
+	uint16_t break_pos;
+	uint16_t break_width;
+	uint16_t line_end;
+	uint16_t next_pos;
+	uint16_t limit;
+	uint16_t free_pixels;
+	SH1106_I2C_TEXT_SPAN* span;
+
+	while((str[pos] != '\0') && (lines < max_lines))
+	{
+		span = &spans[lines];
+		width = 0;
+		break_pos = 0;
+		break_width = 0;
+		wrapped = 0;
+		i = pos;
+
+		//WALK THE LINE UNTIL IT ENDS OR STOPS FITTING
+		while(1)
+		{
+			if(str[i] == '\0')
+			{
+				line_end = i;
+				next_pos = i;
+				break;
+			}
+			if(str[i] == '\n')
+			{
+				line_end = i;
+				next_pos = i + 1;
+				break;
+			}
+
+			advance = _sh1106_i2c_char_advance(advance_table, &font, (uint8_t)str[i]);
+
+			if((flags & SH1106_I2C_TEXT_WRAP) && ((width + advance) > box_width) && (i > pos))
+			{
+				wrapped = 1;
+				if(str[i] == ' ')
+				{
+					//BREAK ON THIS SPACE
+					line_end = i;
+				}
+				else if(break_pos > pos)
+				{
+					//BREAK ON THE LAST SPACE OF THE LINE
+					line_end = break_pos;
+					width = break_width;
+				}
+				else
+				{
+					//SINGLE WORD WIDER THAN THE BOX. BREAK MID WORD
+					line_end = i;
+				}
+				next_pos = line_end;
+				while(str[next_pos] == ' ')
+				{
+					next_pos++;
+				}
+				break;
+			}
+
+			if(str[i] == ' ')
+			{
+				break_pos = i;
+				break_width = width;
+			}
+			width += advance;
+			i++;
+		}
+
+		//TRIM TRAILING SPACES
+		while((line_end > pos) && (str[line_end - 1] == ' '))
+		{
+			line_end--;
+			width -= _sh1106_i2c_char_advance(advance_table, &font, ' ');
+		}
+
+		span->start = pos;
+		span->length = line_end - pos;
+		span->width = width;
+		span->ellipsis = 0;
+		span->x_offset = 0;
+		span->space_extra = 0;
+		span->space_extra_remainder = 0;
+
+		//TRUNCATE LINES THAT DO NOT FIT, AND THE LAST LINE IF TEXT IS LEFT OVER
+		if((span->width > box_width) ||
+			((flags & SH1106_I2C_TEXT_ELLIPSIS) && ((lines + 1) == max_lines) && (str[next_pos] != '\0')))
+		{
+			limit = box_width;
+			if(flags & SH1106_I2C_TEXT_ELLIPSIS)
+			{
+				span->ellipsis = 1;
+				limit = (box_width > (3 * dot_advance)) ? (box_width - (3 * dot_advance)) : 0;
+			}
+			while((span->length > 0) && (span->width > limit))
+			{
+				span->length--;
+				span->width -= _sh1106_i2c_char_advance(advance_table, &font, (uint8_t)str[span->start + span->length]);
+			}
+			while((span->length > 0) && (str[span->start + span->length - 1] == ' '))
+			{
+				span->length--;
+				span->width -= _sh1106_i2c_char_advance(advance_table, &font, ' ');
+			}
+			wrapped = 0;
+		}
+
+		//ALIGN
+		free_pixels = box_width - (span->width + (span->ellipsis ? (3 * dot_advance) : 0));
+		if(free_pixels > box_width)
+		{
+			//ELLIPSIS ALONE WIDER THAN THE BOX
+			free_pixels = 0;
+		}
+		if(align == SH1106_I2C_TEXT_ALIGN_CENTER)
+		{
+			span->x_offset = free_pixels / 2;
+		}
+		else if(align == SH1106_I2C_TEXT_ALIGN_RIGHT)
+		{
+			span->x_offset = free_pixels;
+		}
+		else if((align == SH1106_I2C_TEXT_ALIGN_JUSTIFY) && wrapped)
+		{
+			//ONLY LINES ENDED BY A WRAP ARE STRETCHED, LIKE IN PRINT
+			spaces = 0;
+			for(i = span->start; i < (span->start + span->length); i++)
+			{
+				if(str[i] == ' ')
+				{
+					spaces++;
+				}
+			}
+			if(spaces)
+			{
+				span->space_extra = free_pixels / spaces;
+				span->space_extra_remainder = free_pixels % spaces;
+			}
+		}
+
+		lines++;
+		pos = next_pos;
+	}
+
+	return lines;
+}
+
+void PUT_FUNCTION_IN_FLASH SH1106_I2C_DrawString(char* str, uint8_t x, uint8_t y, const FONT_INFO font, uint8_t color)
+{
+	//DRAW THE SPECIFIED TEXT STRING AT THE GIVEN LOCATION WITH THE SPECIFIED FONT AND COLOR
+
+	uint16_t x_offset = x;
+
+	while(*str)
+	{
+		x_offset += _sh1106_i2c_draw_char((uint8_t)*str, x_offset, y, &font, color);
+		str++;
+	}
+
+	if(_sh1106_i2c_debug)
+	{
+		debug_printf("SH1106 : String written\n");
+	}
+}
+
+void PUT_FUNCTION_IN_FLASH SH1106_I2C_DrawTextBox(const char* str, uint8_t x, uint8_t y, uint8_t box_width, uint8_t box_height, const FONT_INFO font, uint8_t flags, uint8_t color)
+{
+	//LAY OUT THE STRING INSIDE THE SPECIFIED BOX (SEE SH1106_I2C_LayoutText) AND DRAW IT
+	//LINES THAT DO NOT FIT THE BOX HEIGHT ARE NOT DRAWN
+
+	SH1106_I2C_TEXT_SPAN spans[SH1106_I2C_TEXT_MAX_LINES];
+	uint16_t font_height_bits = font.font_char_descriptors[0][1];
+	uint16_t max_lines;
+	uint16_t x_offset;
+	uint16_t i;
+	uint8_t lines;
+	uint8_t line;
+	uint8_t space_counter;
+
+	if(font_height_bits == 0)
+	{
+		//NOTHING TO DRAW WITH
+		return;
+	}
+
+	max_lines = box_height / font_height_bits;
+	if(max_lines > SH1106_I2C_TEXT_MAX_LINES)
+	{
+		max_lines = SH1106_I2C_TEXT_MAX_LINES;
+	}
+
+	lines = SH1106_I2C_LayoutText(str, font, box_width, max_lines, flags, spans);
+
+	for(line = 0; line < lines; line++)
+	{
+		x_offset = x + spans[line].x_offset;
+		space_counter = 0;
+
+		for(i = spans[line].start; i < (spans[line].start + spans[line].length); i++)
+		{
+			x_offset += _sh1106_i2c_draw_char((uint8_t)str[i], x_offset, y, &font, color);
+			if(str[i] == ' ')
+			{
+				x_offset += spans[line].space_extra;
+				if(space_counter < spans[line].space_extra_remainder)
+				{
 					x_offset++;
 				}
-				x_offset -= (char_width_bytes * 8);
-				y_offset++;
+				space_counter++;
+			}
+		}
+
+		if(spans[line].ellipsis)
+		{
+			x_offset += _sh1106_i2c_draw_char('.', x_offset, y, &font, color);
+			x_offset += _sh1106_i2c_draw_char('.', x_offset, y, &font, color);
+			_sh1106_i2c_draw_char('.', x_offset, y, &font, color);
+		}
+		y += font_height_bits;
+	}
+
+	if(_sh1106_i2c_debug)
+	{
+		debug_printf("SH1106 : Text box written (%u lines)\n", lines);
+	}
+}
+
+void PUT_FUNCTION_IN_FLASH SH1106_I2C_TextFieldInit(SH1106_I2C_TEXT_FIELD* field, uint8_t x, uint8_t y, const FONT_INFO font, uint8_t color)
+{
+	//INITIALIZE A TEXT FIELD AT THE SPECIFIED LOCATION. NOTHING IS DRAWN
+	//THE AREA IS ASSUMED TO BE CLEAR (BACKGROUND = !color)
+
+	field->x = x;
+	field->y = y;
+	field->color = color;
+	field->length = 0;
+	field->font = font;
+	field->text[0] = '\0';
+}
+
+uint8_t PUT_FUNCTION_IN_FLASH SH1106_I2C_TextFieldSet(SH1106_I2C_TEXT_FIELD* field, const char* str)
+{
+	//SET A NEW VALUE FOR THE TEXT FIELD
+	//ONLY THE CHARACTER CELLS THAT CHANGED (VALUE OR POSITION) ARE CLEARED AND REDRAWN
+	//AND ONLY THEIR COLUMNS ARE INVALIDATED FOR THE NEXT FLUSH
+	//RETURNS THE NUMBER OF CHARACTERS REDRAWN
+
+	const uint8_t* advance_table = _sh1106_i2c_font_advance_table(&field->font);
+	uint16_t font_height_bits = field->font.font_char_descriptors[0][1];
+	uint16_t span_start[SH1106_I2C_TEXT_FIELD_MAX_CHARS];
+	uint16_t span_end[SH1106_I2C_TEXT_FIELD_MAX_CHARS];
+	uint8_t changed[SH1106_I2C_TEXT_FIELD_MAX_CHARS];
+	uint8_t span_count = 0;
+	uint8_t redrawn = 0;
+	uint8_t new_length = 0;
+	uint8_t old_advance;
+	uint8_t new_advance;
+	uint16_t old_x = field->x;
+	uint16_t new_x = field->x;
+	uint16_t cell_start;
+	uint16_t cell_end;
+	uint16_t y_end;
+	uint8_t i;
+
+	while((str[new_length] != '\0') && (new_length < SH1106_I2C_TEXT_FIELD_MAX_CHARS))
+	{
+		new_length++;
+	}
+
+	//FIND THE CHANGED CELLS AND MERGE THEIR COLUMNS INTO SPANS
+	for(i = 0; (i < field->length) || (i < new_length); i++)
+	{
+		old_advance = (i < field->length) ? _sh1106_i2c_char_advance(advance_table, &field->font, (uint8_t)field->text[i]) : 0;
+		new_advance = (i < new_length) ? _sh1106_i2c_char_advance(advance_table, &field->font, (uint8_t)str[i]) : 0;
+
+		if((i < field->length) && (i < new_length) && (old_x == new_x) && (field->text[i] == str[i]))
+		{
+			changed[i] = 0;
+		}
+		else
+		{
+			if(i < new_length)
+			{
+				changed[i] = 1;
+			}
+
+			//CELL = UNION OF THE OLD AND NEW GLYPH BOXES
+			if(!new_advance || (old_advance && ((old_x + old_advance) > (new_x + new_advance))))
+			{
+				cell_end = old_x + old_advance - 1;
+			}
+			else
+			{
+				cell_end = new_x + new_advance - 1;
+			}
+			if(!new_advance || (old_advance && (old_x < new_x)))
+			{
+				cell_start = old_x;
+			}
+			else
+			{
+				cell_start = new_x;
+			}
+
+			if(span_count && (cell_start <= (span_end[span_count - 1] + 1)))
+			{
+				if(cell_end > span_end[span_count - 1])
+				{
+					span_end[span_count - 1] = cell_end;
+				}
+			}
+			else
+			{
+				span_start[span_count] = cell_start;
+				span_end[span_count] = cell_end;
+				span_count++;
+			}
+		}
+		old_x += old_advance;
+		new_x += new_advance;
+	}
+
+	//CLEAR THE CHANGED SPANS AND MARK THEM FOR THE NEXT FLUSH
+	y_end = field->y + font_height_bits - 1;
+	if(y_end > (SH1106_I2C_OLED_MAX_PAGE * 8 + 7))
+	{
+		y_end = (SH1106_I2C_OLED_MAX_PAGE * 8 + 7);
+	}
+	for(i = 0; i < span_count; i++)
+	{
+		if(span_start[i] > SH1106_I2C_OLED_MAX_COLUMN)
+		{
+			break;
+		}
+		if(span_end[i] > SH1106_I2C_OLED_MAX_COLUMN)
+		{
+			span_end[i] = SH1106_I2C_OLED_MAX_COLUMN;
+		}
+		SH1106_I2C_DrawBoxFilled(span_start[i], field->y, span_end[i], y_end, !field->color);
+		SH1106_I2C_Invalidate(span_start[i], field->y, span_end[i], y_end, SH1106_I2C_INVALIDATE_DEFERRED);
+	}
+
+	//REDRAW THE CHANGED CHARACTERS
+	new_x = field->x;
+	for(i = 0; i < new_length; i++)
+	{
+		if(changed[i])
+		{
+			_sh1106_i2c_draw_char((uint8_t)str[i], new_x, field->y, &field->font, field->color);
+			redrawn++;
+		}
+		new_x += _sh1106_i2c_char_advance(advance_table, &field->font, (uint8_t)str[i]);
+	}
+
+	os_memcpy(field->text, str, new_length);
+	field->text[new_length] = '\0';
+	field->length = new_length;
+
+	if(_sh1106_i2c_debug)
+	{
+		debug_printf("SH1106 : Text field updated (%u characters redrawn)\n", redrawn);
+	}
+	return redrawn;
+}
+
+void PUT_FUNCTION_IN_FLASH SH1106_I2C_DrawBitmap(uint8_t* bitmap, uint8_t x, uint8_t y, uint8_t x_len_bits, uint8_t y_len_bits, uint8_t color)
+{
+	//DRAW BITMAP OF THE SPECIFIED DIMENSIONS AT SPECIFIED X,Y CORDINATES IN THE SPECIFIED COLOR
+	//BITMAP NEEDS TO BE IN ROW MAJOR FORMAT AND DIMENSIONS NEED TO BE MULTIPLE OF 8 BITS
+	//WITH BITMAP WE WILL DO BOTH PIXEL SETTING AND CLEARNING
+
+	uint16_t x_offset = x;
+	uint16_t y_offset = y;
+	uint8_t byte;
+	uint8_t not_color;
+
+	uint16_t row_size_bytes = (x_len_bits / 8);
+
+	if(color == 0)
+	{
+		not_color = 1;
+	}
+	else
+	{
+		not_color = 0;
+	}
+
+	while(y_offset < (y + y_len_bits))
+	{
+		while(x_offset < (x + x_len_bits))
+		{
+			//GET A NEW BYTE FROM BUFFER IF BITS TRAVERSED IN CURRENT ROW EXCEEDS 8
+			if(((x_offset - x) % 8) == 0)
+			{
+				byte = bitmap[(row_size_bytes * (y_offset - y)) + ((x_offset - x) / 8)];
+			}
+
+			//DRAW THE PIXEL IF REQUIRED
+			if(byte & 0x80)
+			{
+				SH1106_I2C_DrawPixel(x_offset, y_offset, color);
+			}
+			else
+			{
+				SH1106_I2C_DrawPixel(x_offset, y_offset, not_color);
+			}
+			x_offset++;
+			if(byte & 0x40)
+			{
+				SH1106_I2C_DrawPixel(x_offset, y_offset, color);
+			}
+			else
+			{
+				SH1106_I2C_DrawPixel(x_offset, y_offset, not_color);
+			}
+			x_offset++;
+			if(byte & 0x20)
+			{
+				SH1106_I2C_DrawPixel(x_offset, y_offset, color);
+			}
+			else
+			{
+				SH1106_I2C_DrawPixel(x_offset, y_offset, not_color);
+			}
+			x_offset++;
+			if(byte & 0x10)
+			{
+				SH1106_I2C_DrawPixel(x_offset, y_offset, color);
+			}
+			else
+			{
+				SH1106_I2C_DrawPixel(x_offset, y_offset, not_color);
+			}
+			x_offset++;
+			if(byte & 0x08)
+			{
+				SH1106_I2C_DrawPixel(x_offset, y_offset, color);
+			}
+			else
+			{
+				SH1106_I2C_DrawPixel(x_offset, y_offset, not_color);
+			}
+			x_offset++;
+			if(byte & 0x04)
+			{
+				SH1106_I2C_DrawPixel(x_offset, y_offset, color);
+			}
+			else
+			{
+				SH1106_I2C_DrawPixel(x_offset, y_offset, not_color);
+			}
+			x_offset++;
+			if(byte & 0x02)
+			{
+				SH1106_I2C_DrawPixel(x_offset, y_offset, color);
+			}
+			else
+			{
+				SH1106_I2C_DrawPixel(x_offset, y_offset, not_color);
+			}
+			x_offset++;
+			if(byte & 0x01)
+			{
+				SH1106_I2C_DrawPixel(x_offset, y_offset, color);
+			}
+			else
+			{
+				SH1106_I2C_DrawPixel(x_offset, y_offset, not_color);
+			}
+			x_offset++;
+		}
+		//RESET x_offset
+		x_offset = x;
+		y_offset++;
+	}
+
+	if(_sh1106_i2c_debug)
+	{
+		debug_printf("SH1106 : Bitmap written of size %u bits\n", (x_len_bits * y_len_bits));
+	}
+}
+
+uint8_t PUT_FUNCTION_IN_FLASH SH1106_I2C_DrawPortraitFrame(const uint8_t* portrait, uint16_t rotation)
+{
+	//COPY A PORTRAIT FRAME INTO THE FRAMEBUFFER ROTATED BY 90 OR 270 DEGREES
+	//PORTRAIT FRAME IS PAGE MAJOR, (MAX_PAGE + 1) * 8 PIXELS WIDE AND (MAX_COLUMN + 1) PIXELS TALL
+	//(SO (MAX_COLUMN + 1) / 8 PAGES OF (MAX_PAGE + 1) * 8 BYTES)
+	//EVERY 8x8 PIXEL BLOCK IS MOVED WITH ONE BIT MATRIX TRANSPOSE INSTEAD OF 64 PIXEL WRITES
+	//ROTATION_90  : PORTRAIT (u,v) -> SCREEN (MAX_COLUMN - v, u)
+	//ROTATION_270 : PORTRAIT (u,v) -> SCREEN (v, MAX_Y - u)
+	//RETURNS 1 IF DRAWN, 0 FOR ANY OTHER ROTATION OR WITHOUT A FRAMEBUFFER (DIRECT MODE)
+
+	const uint16_t portrait_width = (SH1106_I2C_OLED_MAX_PAGE + 1) * 8;
+	const uint8_t portrait_pages = (SH1106_I2C_OLED_MAX_COLUMN + 1) / 8;
+	uint8_t block_in[8];
+	uint8_t block_out[8];
+	uint8_t page;
+	uint8_t block;
+	uint8_t i;
+	uint8_t* dest;
+
+	if(_sh1106_framebuffer_pointer == NULL)
+	{
+		return 0;
+	}
+
+	if((rotation != SH1106_I2C_ROTATION_90) && (rotation != SH1106_I2C_ROTATION_270))
+	{
+		if(_sh1106_i2c_debug)
+		{
+			debug_printf("SH1106 : Portrait rotation %u not supported\n", rotation);
+		}
+		return 0;
+	}
+
+	for(page = 0; page < (SH1106_I2C_OLED_MAX_PAGE + 1); page++)
+	{
+		for(block = 0; block < portrait_pages; block++)
+		{
+			dest = &_sh1106_framebuffer_pointer[(page * (SH1106_I2C_OLED_MAX_COLUMN + 1)) + (block * 8)];
+
+			if(rotation == SH1106_I2C_ROTATION_90)
+			{
+				for(i = 0; i < 8; i++)
+				{
+					block_in[i] = portrait[((portrait_pages - 1 - block) * portrait_width) + (page * 8) + i];
+				}
+				_sh1106_i2c_transpose_8x8(block_in, block_out);
+				for(i = 0; i < 8; i++)
+				{
+					dest[i] = block_out[7 - i];
+				}
+			}
+			else
+			{
+				for(i = 0; i < 8; i++)
+				{
+					block_in[i] = portrait[(block * portrait_width) + (portrait_width - 1) - (page * 8) - i];
+				}
+				_sh1106_i2c_transpose_8x8(block_in, dest);
+			}
+		}
+	}
+
+	if(_sh1106_i2c_debug)
+	{
+		debug_printf("SH1106 : Portrait frame written (rotation %u)\n", rotation);
+	}
+	return 1;
+}
+
+uint8_t PUT_FUNCTION_IN_FLASH SH1106_I2C_GrayStart(uint8_t plane_rate_hz, uint32_t bus_hz)
+{
+	//START 2 BIT (4 LEVEL) GRAYSCALE BY ALTERNATING TWO BIT PLANES plane_rate_hz TIMES A SECOND
+	//THE FRAMEBUFFER IS THE MSB PLANE. AN LSB PLANE IS ALLOCATED AND STARTS AS A COPY OF IT,
+	//SO WHATEVER IS ON THE SCREEN STAYS AT FULL INTENSITY
+	//plane_rate_hz = 0 USES SH1106_I2C_GRAY_DEFAULT_PLANE_RATE_HZ
+	//bus_hz IS THE I2C CLOCK, USED TO DECIDE IF THE PLANE RATE CAN BE SUSTAINED
+	//WHILE ACTIVE, DRAW WITH THE GRAY FUNCTIONS AND SEND WITH SH1106_I2C_GrayUpdate
+	//(SH1106_I2C_UpdateDisplay, SH1106_I2C_FlushDirty AND THE SCHEDULER TICKS ALSO DO A GRAY UPDATE)
+	//RETURNS 1 ON SUCCESS, 0 IF THERE IS NO FRAMEBUFFER OR NO MEMORY FOR THE LSB PLANE
+
+	if(_sh1106_framebuffer_pointer == NULL)
+	{
+		return 0;
+	}
+
+	if(_sh1106_i2c_gray_lsb_plane == NULL)
+	{
+		_sh1106_i2c_gray_lsb_plane = (uint8_t*)os_zalloc((SH1106_I2C_OLED_MAX_COLUMN + 1) * (SH1106_I2C_OLED_MAX_PAGE + 1));
+		if(_sh1106_i2c_gray_lsb_plane == NULL)
+		{
+			if(_sh1106_i2c_debug)
+			{
+				debug_printf("SH1106 : Gray plane allocation failed\n");
+			}
+			return 0;
+		}
+		os_memcpy(_sh1106_i2c_gray_lsb_plane, _sh1106_framebuffer_pointer, (SH1106_I2C_OLED_MAX_COLUMN + 1) * (SH1106_I2C_OLED_MAX_PAGE + 1));
+		_sh1106_i2c_gray_contrast = _sh1106_i2c_contrast;
+	}
+
+	_sh1106_i2c_ram_out_of_sync = 1;
+	_sh1106_i2c_gray_plane_rate = (plane_rate_hz != 0) ? plane_rate_hz : SH1106_I2C_GRAY_DEFAULT_PLANE_RATE_HZ;
+	_sh1106_i2c_gray_bus_hz = bus_hz;
+	os_timer_setfn(&_sh1106_i2c_gray_timer, (os_timer_func_t*)_sh1106_i2c_gray_timer_cb, NULL);
+
+	if(_sh1106_i2c_debug)
+	{
+		debug_printf("SH1106 : Gray mode started (%u planes/s)\n", _sh1106_i2c_gray_plane_rate);
+	}
+
+	SH1106_I2C_GrayUpdate();
+	return 1;
+}
+
+void PUT_FUNCTION_IN_FLASH SH1106_I2C_GrayStop(void)
+{
+	//STOP GRAYSCALE AND GO BACK TO THE 1 BIT FRAMEBUFFER (THE MSB PLANE)
+	//THE LSB PLANE IS FREED AND THE CONTRAST RESTORED
+
+	if(_sh1106_i2c_gray_lsb_plane == NULL)
+	{
+		return;
+	}
+
+	os_timer_disarm(&_sh1106_i2c_gray_timer);
+	if(!_sh1106_i2c_gray_show_plane(0))
+	{
+		//LEAVE THE GRAY SPANS PENDING SO THE NEXT FLUSH PUTS THE MSB PLANE BACK
+		//AND MAKE SURE THE DISPLAY IS NOT LEFT AT THE HALF CONTRAST OF THE LSB PLANE
+		_sh1106_i2c_gray_send_contrast(0);
+		_sh1106_i2c_gray_invalidate_spans();
+	}
+
+	os_free(_sh1106_i2c_gray_lsb_plane);
+	_sh1106_i2c_gray_lsb_plane = NULL;
+	_sh1106_i2c_gray_page_mask = 0;
+	_sh1106_i2c_gray_degraded = 0;
+
+	if(_sh1106_i2c_debug)
+	{
+		debug_printf("SH1106 : Gray mode stopped\n");
+	}
+}
+
+void PUT_FUNCTION_IN_FLASH SH1106_I2C_GrayClear(void)
+{
+	//CLEAR BOTH BIT PLANES (LEVEL 0 EVERYWHERE)
+
+	if(_sh1106_i2c_gray_lsb_plane == NULL)
+	{
+		return;
+	}
+
+	os_memset(_sh1106_framebuffer_pointer, SH1106_I2C_SCREEN_FILL_PATTERN_CLEAR, (SH1106_I2C_OLED_MAX_COLUMN + 1) * (SH1106_I2C_OLED_MAX_PAGE + 1));
+	os_memset(_sh1106_i2c_gray_lsb_plane, SH1106_I2C_SCREEN_FILL_PATTERN_CLEAR, (SH1106_I2C_OLED_MAX_COLUMN + 1) * (SH1106_I2C_OLED_MAX_PAGE + 1));
+}
+
+void PUT_FUNCTION_IN_FLASH SH1106_I2C_GrayDrawPixel(uint8_t x, uint8_t y, uint8_t level)
+{
+	//SET THE PIXEL AT THE SPECIFIED X,Y LOCATION TO AN INTENSITY LEVEL (0 - 3)
+	//BIT 1 OF THE LEVEL GOES TO THE MSB PLANE (FRAMEBUFFER), BIT 0 TO THE LSB PLANE
+
+	uint16_t index;
+	uint8_t mask;
+
+	if((_sh1106_i2c_gray_lsb_plane == NULL) || (x > SH1106_I2C_OLED_MAX_COLUMN) || (y > (SH1106_I2C_OLED_MAX_PAGE * 8 + 7)))
+	{
+		return;
+	}
+
+	index = ((y >> 3) * (SH1106_I2C_OLED_MAX_COLUMN + 1)) + x;
+	mask = 1 << (y & 7);
+
+	if(level & 0x02)
+	{
+		_sh1106_framebuffer_pointer[index] |= mask;
+	}
+	else
+	{
+		_sh1106_framebuffer_pointer[index] &= ~mask;
+	}
+
+	if(level & 0x01)
+	{
+		_sh1106_i2c_gray_lsb_plane[index] |= mask;
+	}
+	else
+	{
+		_sh1106_i2c_gray_lsb_plane[index] &= ~mask;
+	}
+}
+
+void PUT_FUNCTION_IN_FLASH SH1106_I2C_GrayDrawBitmap(const uint8_t* bitmap, uint8_t x, uint8_t y, uint8_t width, uint8_t height)
+{
+	//DRAW A 2 BIT PER PIXEL BITMAP (EG AN ANTI ALIASED GLYPH OR ICON) AT THE SPECIFIED X,Y LOCATION
+	//ROWS ARE (width + 3) / 4 BYTES, FIRST PIXEL OF A BYTE IN ITS TOP 2 BITS
+
+	uint8_t row_bytes = (width + 3) / 4;
+	uint8_t i;
+	uint8_t j;
+
+	for(j = 0; j < height; j++)
+	{
+		for(i = 0; i < width; i++)
+		{
+			SH1106_I2C_GrayDrawPixel(x + i, y + j, (bitmap[(j * row_bytes) + (i >> 2)] >> (6 - ((i & 3) * 2))) & 0x03);
+		}
+	}
+}
+
+void PUT_FUNCTION_IN_FLASH SH1106_I2C_GrayUpdate(void)
+{
+	//TRANSFER THE TWO BIT PLANES TO THE DISPLAY
+	//THE MSB PLANE IS SENT IN FULL (SAME PAGE ADDRESSING AS SH1106_I2C_UpdateDisplay). THEN THE
+	//COLUMN SPANS WHERE THE PLANES DIFFER ARE WORKED OUT ONCE, SO EACH PLANE SWITCH ONLY SENDS
+	//THOSE SPANS PLUS THE CONTRAST. IF THE BUS CANNOT SWITCH THEM AT THE REQUESTED RATE THE
+	//DISPLAY FALLS BACK TO 1 BIT (MSB PLANE ONLY) UNTIL AN UPDATE WITH LESS GRAY AREA
+	//A PAGE OF THE MSB PLANE THAT FAILS TO GO THROUGH IS LEFT PENDING FOR THE NEXT FLUSH
+
+	uint8_t page;
+
+	if(_sh1106_i2c_gray_lsb_plane == NULL)
+	{
+		return;
+	}
+
+	os_timer_disarm(&_sh1106_i2c_gray_timer);
+
+	for(page = 0; page < (SH1106_I2C_OLED_MAX_PAGE + 1); page++)
+	{
+		if(_sh1106_i2c_send_page_span(page, 0, SH1106_I2C_OLED_MAX_COLUMN))
+		{
+			_sh1106_i2c_dirty_page_mask &= ~(1 << page);
+		}
+		else
+		{
+			_sh1106_i2c_dirty_page_mask |= (1 << page);
+			_sh1106_i2c_dirty_column_start[page] = 0;
+			_sh1106_i2c_dirty_column_end[page] = SH1106_I2C_OLED_MAX_COLUMN;
+		}
+
+		_sh1106_i2c_gray_scan_page(page);
+	}
+
+	//THE MSB PLANE IS NOW ON THE DISPLAY
+	_sh1106_i2c_gray_plane = 0;
+	_sh1106_i2c_gray_send_contrast(0);
+
+	_sh1106_i2c_gray_arm();
+}
+
+uint16_t PUT_FUNCTION_IN_FLASH SH1106_I2C_GrayEstimatePlaneRate(uint32_t bus_hz)
+{
+	//ESTIMATE HOW MANY PLANE SWITCHES PER SECOND AN I2C BUS AT bus_hz CAN CARRY FOR THE
+	//CURRENT GRAY CONTENT (AS OF THE LAST SH1106_I2C_GrayUpdate)
+	//PER SWITCH : CONTRAST (4 BYTES) + PER GRAY PAGE CURSOR (5) AND DATA (2 + SPAN) BYTES
+	//AT 9 CLOCKS PER BYTE, PLUS ABOUT 2 CLOCKS OF START / STOP PER TRANSACTION
+	//RETURNS 0xFFFF IF NOTHING NEEDS TO ALTERNATE
+
+	uint32_t bytes = 4;
+	uint32_t transactions = 1;
+	uint32_t rate;
+	uint8_t page;
+
+	if(_sh1106_i2c_gray_page_mask == 0)
+	{
+		return 0xFFFF;
+	}
+
+	for(page = 0; page < (SH1106_I2C_OLED_MAX_PAGE + 1); page++)
+	{
+		if(_sh1106_i2c_gray_page_mask & (1 << page))
+		{
+			bytes += 5 + 2 + (_sh1106_i2c_gray_span_end[page] - _sh1106_i2c_gray_span_start[page] + 1);
+			transactions += 2;
+		}
+	}
+
+	rate = bus_hz / ((bytes * 9) + (transactions * 2));
+	return (rate > 0xFFFF) ? 0xFFFF : (uint16_t)rate;
+}
+
+uint8_t PUT_FUNCTION_IN_FLASH SH1106_I2C_GrayIsDegraded(void)
+{
+	//RETURN 1 IF GRAYSCALE FELL BACK TO 1 BIT BECAUSE THE BUS CANNOT KEEP UP
+	//(ESTIMATED FROM THE BUS CLOCK, OR PLANE SWITCHES MEASURED OVERRUNNING THEIR SLOT)
+
+	return _sh1106_i2c_gray_degraded;
+}
+
+static uint8_t PUT_FUNCTION_IN_FLASH _sh1106_i2c_send_init_commands(void)
+{
+	//SEND THE DISPLAY INIT COMMAND STREAM WITH THE DEFAULT PARAMETERS
+	//RETURNS 1 IF ACKED. THE DRIVER STATE IS ONLY SET TO THE DEFAULTS THEN
+
+	_sh1106_i2c_transaction_start();
+
+	//SET I2C SLAVE WRITE ADDRESS
+	_sh1106_i2c_transaction_send((_sh1106_i2c_slave_address << 1));
+
+	//SET TYPE TO COMMAND STREAM
+	_sh1106_i2c_transaction_send(SH1106_I2C_CONTROL_BYTE_CMD_STREAM);
+
+	//DISPLAY OFF
+	_sh1106_i2c_transaction_send(SH1106_I2C_CMD_SET_DISPLAY_OFF);
+
+	//SET COLUMN ADDRESS = OLED COLUMN 0
+	//BECAUSE THIS CONTROLLER HAS RAM SIZE 132 X 64 WHEREAS OUR DISPLAY
+	//IS 128 X 64. SO THE OLED IS MAPPED FROM RAM COLUMN OFFSET ONWARDS
+	_sh1106_i2c_transaction_send(SH1106_I2C_CMD_SET_COLUMN_LOWER_4 | (_sh1106_i2c_column_offset & 0x0F));
+	_sh1106_i2c_transaction_send(SH1106_I2C_CMD_SET_COLUMN_UPPER_4 | (_sh1106_i2c_column_offset >> 4));
+
+	//SET START PAGE ADDRESS = 0
+	_sh1106_i2c_transaction_send(SH1106_I2C_CMD_SET_PAGE_ADDRESS | 0);
+
+	//SET COMMON OUTPUT SCAN DIRECTION = TOP -> BOTTOM (UNLESS FLIPPED VERTICALLY)
+	_sh1106_i2c_transaction_send(SH1106_I2C_CMD_SET_COMMON_SCAN_DIRECTION | ((_sh1106_i2c_orientation & SH1106_I2C_ORIENTATION_FLIP_VERTICAL) ? 0 : 8));
+
+	//_sh1106_i2c_send_byte_function(0x00);
+	//_sh1106_i2c_send_byte_function(0x10);
+
+	//SET DISPLAY START LINE = 0
+	_sh1106_i2c_transaction_send(SH1106_I2C_CMD_SET_DISPLAY_START_LINE | 0);
+
+	//SET CONTRAST
+	_sh1106_i2c_transaction_send(SH1106_I2C_CMD_SET_CONTRAST_CONTROL_MODE);
+	_sh1106_i2c_transaction_send(SH1106_I2C_DEFAULT_CONTRAST);
+
+	//SET SEGMENT REMAP (UNLESS FLIPPED HORIZONTALLY)
+	_sh1106_i2c_transaction_send(SH1106_I2C_CMD_SET_SEGMENT_REMAP | ((_sh1106_i2c_orientation & SH1106_I2C_ORIENTATION_FLIP_HORIZONTAL) ? 0 : 1));
+
+	//SET DISPLAY = NORMAL
+	_sh1106_i2c_transaction_send(SH1106_I2C_CMD_SET_DISPLAY_NORMAL);
+
+	//SET MULTIPLEX RATIO = ALL ROWS
+	_sh1106_i2c_transaction_send(SH1106_I2C_CMD_SET_MULTIPLEX_RATIO);
+	_sh1106_i2c_transaction_send(SH1106_I2C_OLED_MULTIPLEX_RATIO);
+
+	//SET ENTIRE DISPLAY = ON
+	_sh1106_i2c_transaction_send(SH1106_I2C_CMD_SET_ENTIRE_DISPLAY_ON);
+
+	//SET DISPLAY OFFSET = 0
+	_sh1106_i2c_transaction_send(SH1106_I2C_CMD_SET_DISPLAY_OFFSET_MODE);
+	_sh1106_i2c_transaction_send(0x00);
+
+	//SET DISPLAY OSCILLATOR FREQUENCY
+	_sh1106_i2c_transaction_send(SH1106_I2C_CMD_SET_OSCILLATOR_FREQUENCY);
+	_sh1106_i2c_transaction_send(0xF0);
+
+	//SET DISCHARGE-PRECHARGE PERIOD
+	_sh1106_i2c_transaction_send(SH1106_I2C_CMD_SET_DISCHARGE_PRECHARGE);
+	_sh1106_i2c_transaction_send(0x22);
+
+	//SET COMMON PADS HARDWARE CONFIG
+	_sh1106_i2c_transaction_send(SH1106_I2C_CMD_COMMON_PADS_HARDWARE_CONFIG);
+	_sh1106_i2c_transaction_send(SH1106_I2C_OLED_COM_PADS_CONFIG);
+
+	//SET COMMON PAD OUTPUT VOLTAGE
+	_sh1106_i2c_transaction_send(SH1106_I2C_CMD_COMMON_PADS_OUTPUT_VOLTAGE);
+	_sh1106_i2c_transaction_send(0x20);
+
+	_sh1106_i2c_transaction_send(0x8D);
+	_sh1106_i2c_transaction_send(0x14);
+
+	//SET DISPLAY ON
+	_sh1106_i2c_transaction_send(SH1106_I2C_CMD_SET_DISPLAY_ON);
+
+	if(!_sh1106_i2c_transaction_stop())
+	{
+		return 0;
+	}
+
+	_sh1106_i2c_contrast = SH1106_I2C_DEFAULT_CONTRAST;
+	_sh1106_i2c_display_on = 1;
+	_sh1106_i2c_inverted = 0;
+	return 1;
+}
+
+static uint8_t PUT_FUNCTION_IN_FLASH _sh1106_i2c_clear_display_ram(void)
+{
+	//CLEAR THE DISPLAY RAM SEEN BY THE OLED (AT THE CURRENT COLUMN OFFSET)
+	//RETURNS 1 IF EVERY PAGE WAS ACKED
+
+	uint8_t page;
+	uint8_t x;
+	uint8_t result = 1;
+
+	for(page = 0; page < (SH1106_I2C_OLED_MAX_PAGE + 1); page++)
+	{
+		//DATA IS ONLY SENT ONCE THE CURSOR IS KNOWN TO BE SET
+		if(!_sh1106_i2c_set_cursor(page, _sh1106_i2c_column_offset))
+		{
+			result = 0;
+			continue;
+		}
+		_sh1106_i2c_transaction_start();
+		_sh1106_i2c_transaction_send((_sh1106_i2c_slave_address << 1));
+		_sh1106_i2c_transaction_send(SH1106_I2C_CONTROL_BYTE_DATA_STREAM);
+		for(x = 0; x <= SH1106_I2C_OLED_MAX_COLUMN; x++)
+		{
+			_sh1106_i2c_transaction_send(SH1106_I2C_SCREEN_FILL_PATTERN_CLEAR);
+		}
+		if(!_sh1106_i2c_transaction_stop())
+		{
+			result = 0;
+		}
+	}
+	return result;
+}
+
+static void PUT_FUNCTION_IN_FLASH _sh1106_i2c_update_column_offset(void)
+{
+	//WORK OUT WHERE THE OLED COLUMN 0 IS IN THE 132 COLUMN RAM FOR THE CURRENT ORIENTATION
+	//WHEN FLIPPED HORIZONTALLY THE OLED IS SEEN FROM THE OTHER END OF THE RAM
+
+	if(_sh1106_i2c_orientation & SH1106_I2C_ORIENTATION_FLIP_HORIZONTAL)
+	{
+		_sh1106_i2c_column_offset = SH1106_I2C_RAM_COLUMNS - (SH1106_I2C_OLED_MAX_COLUMN + 1) - SH1106_I2C_OLED_COLUMN_OFFSET;
+	}
+	else
+	{
+		_sh1106_i2c_column_offset = SH1106_I2C_OLED_COLUMN_OFFSET;
+	}
+}
+
+static uint16_t PUT_FUNCTION_IN_FLASH _sh1106_i2c_checksum(const uint8_t* data, uint16_t len)
+{
+	//CRC-16/CCITT (POLYNOMIAL 0x1021, INITIAL VALUE 0xFFFF) OF THE DATA
+	//(A MOD 255 FLETCHER SUM CANNOT TELL 0x00 FROM 0xFF, IE A BLANK FROM A LIT SEGMENT)
+
+	uint16_t crc = 0xFFFF;
+	uint8_t bit;
+
+	while(len--)
+	{
+		crc ^= (uint16_t)(*data++) << 8;
+		for(bit = 0; bit < 8; bit++)
+		{
+			crc = (crc & 0x8000) ? ((crc << 1) ^ 0x1021) : (crc << 1);
+		}
+	}
+	return crc;
+}
+
+static void PUT_FUNCTION_IN_FLASH _sh1106_i2c_transaction_start(void)
+{
+	//START A TRANSACTION ON THE BUS
+
+	_sh1106_i2c_transaction_nacked = 0;
+	_sh1106_i2c_send_start_function();
+}
+
+static void PUT_FUNCTION_IN_FLASH _sh1106_i2c_transaction_send(uint8_t byte)
+{
+	//SEND A BYTE OF THE CURRENT TRANSACTION AND CHECK IT IS ACKED (BACKEND RETURNS NON 0)
+	//ONCE A BYTE IS NACKED THE REST OF THE TRANSACTION IS NOT CLOCKED OUT
+
+	if(_sh1106_i2c_transaction_nacked)
+	{
+		return;
+	}
+
+	if(!_sh1106_i2c_send_byte_function(byte))
+	{
+		_sh1106_i2c_transaction_nacked = 1;
+	}
+}
+
+static uint8_t PUT_FUNCTION_IN_FLASH _sh1106_i2c_transaction_stop(void)
+{
+	//END THE CURRENT TRANSACTION
+	//RETURNS 1 IF EVERY BYTE WAS ACKED, 0 OTHERWISE
+
+	_sh1106_i2c_send_stop_function();
+
+	_sh1106_i2c_transport_stats.transactions++;
+	if(_sh1106_i2c_transaction_nacked)
+	{
+		_sh1106_i2c_transport_stats.failed_transactions++;
+		if(_sh1106_i2c_debug)
+		{
+			debug_printf("SH1106 : I2C : Transaction NACKed\n");
+		}
+		return 0;
+	}
+	return 1;
+}
+
+static uint8_t PUT_FUNCTION_IN_FLASH _sh1106_i2c_set_cursor(uint8_t page, uint8_t ram_column)
+{
+	//SET THE DISPLAY RAM CURSOR TO THE SPECIFIED PAGE AND RAM COLUMN (0 - 131)
+	//RETURNS 1 IF THE COMMANDS WERE ACKED
+
+	_sh1106_i2c_transaction_start();
+	_sh1106_i2c_transaction_send((_sh1106_i2c_slave_address << 1));
+	_sh1106_i2c_transaction_send(SH1106_I2C_CONTROL_BYTE_CMD_STREAM);
+
+	//SET COLUMN
+	_sh1106_i2c_transaction_send(SH1106_I2C_CMD_SET_COLUMN_UPPER_4 | (ram_column >> 4));
+	_sh1106_i2c_transaction_send(SH1106_I2C_CMD_SET_COLUMN_LOWER_4 | (ram_column & 0x0F));
+
+	//SET PAGE
+	_sh1106_i2c_transaction_send(SH1106_I2C_CMD_SET_PAGE_ADDRESS | page);
+	return _sh1106_i2c_transaction_stop();
+}
+
+static uint8_t PUT_FUNCTION_IN_FLASH _sh1106_i2c_send_page_span(uint8_t page, uint8_t x_start, uint8_t x_end)
+{
+	//SEND THE FRAMEBUFFER COLUMNS [x_start, x_end] OF THE SPECIFIED PAGE
+	//A PAGE THAT STILL FAILS AFTER ITS RETRIES IS MARKED SUSPECT UNTIL IT IS SENT FINE
+	//RETURNS 1 ON SUCCESS
+
+	if(_sh1106_i2c_send_page_data(page, x_start, &_sh1106_framebuffer_pointer[(page * (SH1106_I2C_OLED_MAX_COLUMN + 1)) + x_start], (x_end - x_start + 1)))
+	{
+		_sh1106_i2c_suspect_page_mask &= ~(1 << page);
+		return 1;
+	}
+
+	_sh1106_i2c_suspect_page_mask |= (1 << page);
+	_sh1106_i2c_transport_stats.pages_failed++;
+	if(_sh1106_i2c_debug)
+	{
+		debug_printf("SH1106 : Page %u marked suspect\n", page);
+	}
+	return 0;
+}
+
+static uint8_t PUT_FUNCTION_IN_FLASH _sh1106_i2c_send_page_data(uint8_t page, uint8_t x_start, const uint8_t* data, uint16_t len)
+{
+	//SEND len BYTES OF PAGE DATA STARTING AT OLED COLUMN x_start OF THE SPECIFIED PAGE
+	//RETURNS 1 ON SUCCESS
+
+	return _sh1106_i2c_send_ram_data(page, x_start + _sh1106_i2c_column_offset, data, len);
+}
+
+static uint8_t PUT_FUNCTION_IN_FLASH _sh1106_i2c_send_ram_data(uint8_t page, uint8_t ram_column, const uint8_t* data, uint16_t len)
+{
+	//SEND len BYTES OF PAGE DATA STARTING AT RAM COLUMN ram_column OF THE SPECIFIED PAGE
+	//COLUMN AUTO INCREMENTS ON THE DISPLAY SO ONLY THE START NEEDS TO BE SET
+	//A NACKED TRANSFER IS RETRIED (CURSOR AND DATA) FOR THIS PAGE ONLY, WITH A
+	//DOUBLING BACKOFF BETWEEN ATTEMPTS. RETURNS 1 ON SUCCESS
+
+	uint16_t x;
+	uint16_t backoff_us = SH1106_I2C_TRANSPORT_BACKOFF_US;
+	uint8_t attempt;
+
+	_sh1106_i2c_transport_stats.page_transfers++;
+
+	for(attempt = 0; ; attempt++)
+	{
+		//DATA IS ONLY SENT ONCE THE CURSOR IS KNOWN TO BE SET. OTHERWISE IT
+		//WOULD LAND AT THE OLD CURSOR POSITION, POSSIBLY IN ANOTHER PAGE
+		if(_sh1106_i2c_set_cursor(page, ram_column))
+		{
+			_sh1106_i2c_transaction_start();
+			_sh1106_i2c_transaction_send((_sh1106_i2c_slave_address << 1));
+			_sh1106_i2c_transaction_send(SH1106_I2C_CONTROL_BYTE_DATA_STREAM);
+
+			for(x = 0; x < len; x++)
+			{
+				_sh1106_i2c_transaction_send(data[x]);
+			}
+			if(_sh1106_i2c_transaction_stop())
+			{
+				if(attempt)
+				{
+					_sh1106_i2c_transport_stats.pages_recovered++;
+				}
+				return 1;
+			}
+		}
+
+		if(attempt >= SH1106_I2C_TRANSPORT_MAX_RETRIES)
+		{
+			return 0;
+		}
+
+		_sh1106_i2c_transport_stats.page_retries++;
+		os_delay_us(backoff_us);
+		backoff_us <<= 1;
+		if(backoff_us > SH1106_I2C_TRANSPORT_BACKOFF_MAX_US)
+		{
+			backoff_us = SH1106_I2C_TRANSPORT_BACKOFF_MAX_US;
+		}
+	}
+}
+
+#ifdef SH1106_I2C_DIRECT_MODE
+static void PUT_FUNCTION_IN_FLASH _sh1106_i2c_direct_send(uint8_t byte)
+{
+	//SEND A BYTE AND COUNT IT FOR THE DIRECT MODE STATISTICS
+	//BYTES DROPPED AFTER A NACK NEVER REACH THE WIRE SO ARE NOT COUNTED
+
+	if(!_sh1106_i2c_transaction_nacked)
+	{
+		_sh1106_i2c_direct_stats.bytes_on_wire++;
+	}
+	_sh1106_i2c_transaction_send(byte);
+}
+
+static uint8_t PUT_FUNCTION_IN_FLASH _sh1106_i2c_direct_command(const uint8_t* commands, uint8_t command_count)
+{
+	//SEND A COMMAND STREAM TRANSACTION
+	//RETURNS 1 IF EVERY BYTE WAS ACKED
+
+	uint8_t i;
+
+	_sh1106_i2c_transaction_start();
+	_sh1106_i2c_direct_send((_sh1106_i2c_slave_address << 1));
+	_sh1106_i2c_direct_send(SH1106_I2C_CONTROL_BYTE_CMD_STREAM);
+	for(i = 0; i < command_count; i++)
+	{
+		_sh1106_i2c_direct_send(commands[i]);
+	}
+	return _sh1106_i2c_transaction_stop();
+}
+
+static uint8_t PUT_FUNCTION_IN_FLASH _sh1106_i2c_direct_update_span(uint8_t page, uint8_t x_start, uint8_t x_end, uint8_t mask, uint8_t color)
+{
+	//SET (color = 1) OR CLEAR THE mask BITS OF COLUMNS [x_start, x_end] OF THE PAGE IN THE DISPLAY RAM
+	//A FULL MASK NEEDS NO READ, SO THE SPAN IS WRITTEN AS ONE DATA STREAM
+	//OTHERWISE EVERY BYTE IS READ, MODIFIED AND WRITTEN BACK IN READ-MODIFY-WRITE MODE,
+	//WHERE ONLY THE WRITE MOVES THE COLUMN ON. THE DUMMY READ IS ONLY NEEDED ONCE,
+	//RIGHT AFTER THE ADDRESS IS SET, SO THE FIRST READ OF THE SPAN CLOCKS 2 BYTES
+	//RETURNS 1 ON SUCCESS. A NACK STOPS THE SPAN SO NO BYTE IS WRITTEN FROM A FAILED READ
+
+	uint8_t commands[4];
+	uint8_t column = x_start + _sh1106_i2c_column_offset;
+	uint8_t byte = 0;
+	uint8_t dummy_read = 1;
+	uint8_t result;
+	uint16_t x;
+
+	commands[0] = SH1106_I2C_CMD_SET_COLUMN_UPPER_4 | (column >> 4);
+	commands[1] = SH1106_I2C_CMD_SET_COLUMN_LOWER_4 | (column & 0x0F);
+	commands[2] = SH1106_I2C_CMD_SET_PAGE_ADDRESS | page;
+	commands[3] = SH1106_I2C_CMD_SET_READ_MODIFY_WRITE;
+
+	//THE SHADOW PATH WOULD FLUSH THE SAME SPAN : CURSOR (ADDRESS, CONTROL, 3 COMMANDS)
+	//THEN DATA (ADDRESS, CONTROL, 1 BYTE PER COLUMN)
+	_sh1106_i2c_direct_stats.shadow_bytes_equivalent += 5 + 2 + (x_end - x_start + 1);
+
+	if(mask == 0xFF)
+	{
+		//DATA IS ONLY SENT ONCE THE CURSOR IS KNOWN TO BE SET
+		if(!_sh1106_i2c_direct_command(commands, 3))
+		{
+			return 0;
+		}
+
+		_sh1106_i2c_transaction_start();
+		_sh1106_i2c_direct_send((_sh1106_i2c_slave_address << 1));
+		_sh1106_i2c_direct_send(SH1106_I2C_CONTROL_BYTE_DATA_STREAM);
+		for(x = x_start; x <= x_end; x++)
+		{
+			_sh1106_i2c_direct_send(color ? SH1106_I2C_SCREEN_FILL_PATTERN_FILL : SH1106_I2C_SCREEN_FILL_PATTERN_CLEAR);
+		}
+		return _sh1106_i2c_transaction_stop();
+	}
+
+	//THE DISPLAY MAY HAVE TAKEN THE RMW COMMAND EVEN IF A LATER BYTE FAILED,
+	//SO RMW MODE IS ENDED BELOW EITHER WAY
+	result = _sh1106_i2c_direct_command(commands, 4);
+
+	for(x = x_start; result && (x <= x_end); x++)
+	{
+		//READ
+		_sh1106_i2c_transaction_start();
+		_sh1106_i2c_direct_send((_sh1106_i2c_slave_address << 1));
+		_sh1106_i2c_direct_send(SH1106_I2C_CONTROL_BYTE_DATA_STREAM);
+		//REPEATED START (SAME TRANSACTION)
+		if(!_sh1106_i2c_transaction_nacked)
+		{
+			_sh1106_i2c_send_start_function();
+		}
+		_sh1106_i2c_direct_send((_sh1106_i2c_slave_address << 1) | 1);
+		if(!_sh1106_i2c_transaction_nacked)
+		{
+			if(dummy_read)
+			{
+				_sh1106_i2c_read_byte_function(1);
+				_sh1106_i2c_direct_stats.bytes_on_wire++;
+				dummy_read = 0;
+			}
+			byte = _sh1106_i2c_read_byte_function(0);
+			_sh1106_i2c_direct_stats.bytes_on_wire++;
+		}
+		if(!_sh1106_i2c_transaction_stop())
+		{
+			result = 0;
+			break;
+		}
+
+		//MODIFY
+		if(color)
+		{
+			byte |= mask;
+		}
+		else
+		{
+			byte &= ~mask;
+		}
+
+		//WRITE (COLUMN MOVES ON)
+		_sh1106_i2c_transaction_start();
+		_sh1106_i2c_direct_send((_sh1106_i2c_slave_address << 1));
+		_sh1106_i2c_direct_send(SH1106_I2C_CONTROL_BYTE_DATA_SINGLE);
+		_sh1106_i2c_direct_send(byte);
+		if(!_sh1106_i2c_transaction_stop())
+		{
+			result = 0;
+			break;
+		}
+	}
+
+	//ALWAYS LEAVE READ-MODIFY-WRITE MODE, EVEN AFTER A FAILURE
+	commands[0] = SH1106_I2C_CMD_SET_READ_MODIFY_WRITE_END;
+	if(!_sh1106_i2c_direct_command(commands, 1))
+	{
+		result = 0;
+	}
+
+	if(!result && _sh1106_i2c_debug)
+	{
+		debug_printf("SH1106 : Direct update of page %u failed\n", page);
+	}
+	return result;
+}
+#endif
+
+static void PUT_FUNCTION_IN_FLASH _sh1106_i2c_scheduler_timer_cb(void* arg)
+{
+	//FRAME TICK OF THE REFRESH SCHEDULER
+	//FLUSH WHATEVER WAS INVALIDATED SINCE THE LAST TICK
+
+	if(_sh1106_i2c_dirty_page_mask == 0)
+	{
+		return;
+	}
+
+	_sh1106_i2c_scheduler_stats.scheduled_flushes++;
+	SH1106_I2C_FlushDirty();
+}
+
+static void PUT_FUNCTION_IN_FLASH _sh1106_i2c_effect_timer_cb(void* arg)
+{
+	//SEND THE CURRENT EFFECT STEP (AND ANY FOLLOWING 0 DELAY STEPS) AS ONE
+	//COMMAND STREAM, THEN ARM THE TIMER FOR THE NEXT STEP
+
+	SH1106_I2C_EFFECT_STEP* step;
+	uint8_t first_step = _sh1106_i2c_effect_step_index;
+	uint8_t i;
+
+	if(!_sh1106_i2c_effect_running)
+	{
+		return;
+	}
+
+	_sh1106_i2c_transaction_start();
+	_sh1106_i2c_transaction_send((_sh1106_i2c_slave_address << 1));
+	_sh1106_i2c_transaction_send(SH1106_I2C_CONTROL_BYTE_CMD_STREAM);
+
+	do
+	{
+		step = &_sh1106_i2c_effect_steps[_sh1106_i2c_effect_step_index];
+		for(i = 0; i < step->command_count; i++)
+		{
+			_sh1106_i2c_transaction_send(step->commands[i]);
+		}
+		_sh1106_i2c_effect_step_index++;
+	}
+	while((step->delay_ms == 0) && (_sh1106_i2c_effect_step_index < _sh1106_i2c_effect_step_count));
+
+	if(_sh1106_i2c_transaction_stop())
+	{
+		//KEEP THE CONTROLLER STATE (SAVED FOR WARM RESUME) IN STEP WITH WHAT WAS SENT
+		for(i = first_step; i < _sh1106_i2c_effect_step_index; i++)
+		{
+			_sh1106_i2c_effect_track_state(&_sh1106_i2c_effect_steps[i]);
+		}
+	}
+
+	if(_sh1106_i2c_effect_step_index >= _sh1106_i2c_effect_step_count)
+	{
+		if(!_sh1106_i2c_effect_repeat)
+		{
+			_sh1106_i2c_effect_running = 0;
+			if(_sh1106_i2c_debug)
+			{
+				debug_printf("SH1106 : Effect done\n");
+			}
+			if(_sh1106_i2c_effect_done_cb != NULL)
+			{
+				_sh1106_i2c_effect_done_cb();
+			}
+			return;
+		}
+		_sh1106_i2c_effect_step_index = 0;
+	}
+
+	os_timer_arm(&_sh1106_i2c_effect_timer, (step->delay_ms != 0) ? step->delay_ms : 1, 0);
+}
+
+static void PUT_FUNCTION_IN_FLASH _sh1106_i2c_effect_track_state(const SH1106_I2C_EFFECT_STEP* step)
+{
+	//UPDATE THE CONTRAST / INVERTED / DISPLAY ON STATE FOR THE COMMANDS OF A SENT EFFECT STEP
+
+	uint8_t i;
+
+	for(i = 0; i < step->command_count; i++)
+	{
+		if(step->commands[i] == SH1106_I2C_CMD_SET_CONTRAST_CONTROL_MODE)
+		{
+			if((i + 1) < step->command_count)
+			{
+				_sh1106_i2c_contrast = step->commands[++i];
+			}
+		}
+		else if(step->commands[i] == SH1106_I2C_CMD_SET_DISPLAY_ON)
+		{
+			_sh1106_i2c_display_on = 1;
+		}
+		else if(step->commands[i] == SH1106_I2C_CMD_SET_DISPLAY_OFF)
+		{
+			_sh1106_i2c_display_on = 0;
+		}
+		else if(step->commands[i] == SH1106_I2C_CMD_SET_DISPLAY_NORMAL)
+		{
+			_sh1106_i2c_inverted = 0;
+		}
+		else if(step->commands[i] == SH1106_I2C_CMD_SET_DISPLAY_REVERSED)
+		{
+			_sh1106_i2c_inverted = 1;
+		}
+	}
+}
+
+static void PUT_FUNCTION_IN_FLASH _sh1106_i2c_gray_timer_cb(void* arg)
+{
+	//PLANE TICK OF THE GRAYSCALE MODE. SWITCH TO THE OTHER BIT PLANE
+	//IF THE SWITCH FAILS THE PLANE IS NOT TOGGLED, SO THE NEXT TICK SENDS THE SAME PLANE AGAIN
+	//EACH SWITCH IS TIMED. AFTER SH1106_I2C_GRAY_MAX_OVERRUNS SWITCHES IN A ROW LONGER THAN
+	//THEIR SLOT THE BUS IS NOT KEEPING UP, SO THE DISPLAY FALLS BACK TO 1 BIT (MSB PLANE)
+
+	uint32_t start = system_get_time();
+
+	if(_sh1106_i2c_gray_show_plane(_sh1106_i2c_gray_plane ^ 1))
+	{
+		_sh1106_i2c_gray_plane ^= 1;
+	}
+
+	if((system_get_time() - start) <= (1000000 / _sh1106_i2c_gray_plane_rate))
+	{
+		_sh1106_i2c_gray_overruns = 0;
+		return;
+	}
+
+	_sh1106_i2c_gray_overruns++;
+	if(_sh1106_i2c_gray_overruns < SH1106_I2C_GRAY_MAX_OVERRUNS)
+	{
+		return;
+	}
+
+	os_timer_disarm(&_sh1106_i2c_gray_timer);
+	_sh1106_i2c_gray_degraded = 1;
+	if(_sh1106_i2c_gray_plane)
+	{
+		if(_sh1106_i2c_gray_show_plane(0))
+		{
+			_sh1106_i2c_gray_plane = 0;
+		}
+		else
+		{
+			//THE NEXT FLUSH PUTS THE MSB PLANE BACK
+			_sh1106_i2c_gray_invalidate_spans();
+		}
+	}
+
+	if(_sh1106_i2c_debug)
+	{
+		debug_printf("SH1106 : Gray plane switches overrunning. Showing 1 bit\n");
+	}
+}
+
+static uint8_t PUT_FUNCTION_IN_FLASH _sh1106_i2c_gray_show_plane(uint8_t plane)
+{
+	//PUT A BIT PLANE ON THE DISPLAY (0 = MSB, 1 = LSB)
+	//ONLY THE COLUMNS WHERE THE PLANES DIFFER ARE SENT. THE LSB PLANE IS SHOWN AT HALF THE
+	//CONTRAST, SO WITH EQUAL TIME SLOTS THE 4 LEVELS COME OUT AS 0, 1/3, 2/3 AND FULL
+	//A PAGE THAT FAILS STOPS THE SWITCH BEFORE THE CONTRAST CHANGES AND IS MARKED SUSPECT
+	//RETURNS 1 IF THE WHOLE PLANE AND ITS CONTRAST WENT THROUGH
+
+	const uint8_t* data = plane ? _sh1106_i2c_gray_lsb_plane : _sh1106_framebuffer_pointer;
+	uint8_t page;
+
+	for(page = 0; page < (SH1106_I2C_OLED_MAX_PAGE + 1); page++)
+	{
+		if(_sh1106_i2c_gray_page_mask & (1 << page))
+		{
+			if(!_sh1106_i2c_send_page_data(page, _sh1106_i2c_gray_span_start[page], &data[(page * (SH1106_I2C_OLED_MAX_COLUMN + 1)) + _sh1106_i2c_gray_span_start[page]], (_sh1106_i2c_gray_span_end[page] - _sh1106_i2c_gray_span_start[page] + 1)))
+			{
+				_sh1106_i2c_suspect_page_mask |= (1 << page);
+				_sh1106_i2c_transport_stats.pages_failed++;
+				_sh1106_i2c_ram_out_of_sync = 1;
+				if(_sh1106_i2c_debug)
+				{
+					debug_printf("SH1106 : Gray plane %u switch failed on page %u\n", plane, page);
+				}
+				return 0;
 			}
 		}
-		x_offset += (char_width_bytes * 8);
 	}
 
-	if(_sh1106_i2c_debug)
+	return _sh1106_i2c_gray_send_contrast(plane);
+}
+
+static uint8_t PUT_FUNCTION_IN_FLASH _sh1106_i2c_gray_send_contrast(uint8_t plane)
+{
+	//SET THE CONTRAST FOR THE BIT PLANE ON THE DISPLAY (FULL FOR MSB, HALF FOR LSB)
+	//RETURNS 1 IF ACKED
+
+	_sh1106_i2c_transaction_start();
+	_sh1106_i2c_transaction_send((_sh1106_i2c_slave_address << 1));
+	_sh1106_i2c_transaction_send(SH1106_I2C_CONTROL_BYTE_CMD_STREAM);
+	_sh1106_i2c_transaction_send(SH1106_I2C_CMD_SET_CONTRAST_CONTROL_MODE);
+	_sh1106_i2c_transaction_send(plane ? (_sh1106_i2c_gray_contrast >> 1) : _sh1106_i2c_gray_contrast);
+	return _sh1106_i2c_transaction_stop();
+}
+
+static void PUT_FUNCTION_IN_FLASH _sh1106_i2c_gray_scan_page(uint8_t page)
+{
+	//WORK OUT THE COLUMN SPAN OF THE PAGE WHERE THE TWO BIT PLANES DIFFER
+
+	const uint8_t* msb = &_sh1106_framebuffer_pointer[page * (SH1106_I2C_OLED_MAX_COLUMN + 1)];
+	const uint8_t* lsb = &_sh1106_i2c_gray_lsb_plane[page * (SH1106_I2C_OLED_MAX_COLUMN + 1)];
+	uint8_t x;
+
+	_sh1106_i2c_gray_page_mask &= ~(1 << page);
+	for(x = 0; x <= SH1106_I2C_OLED_MAX_COLUMN; x++)
 	{
-		debug_printf("SH1106 : String written\n");
+		if(msb[x] != lsb[x])
+		{
+			if(!(_sh1106_i2c_gray_page_mask & (1 << page)))
+			{
+				_sh1106_i2c_gray_page_mask |= (1 << page);
+				_sh1106_i2c_gray_span_start[page] = x;
+			}
+			_sh1106_i2c_gray_span_end[page] = x;
+		}
 	}
 }
 
-void PUT_FUNCTION_IN_FLASH SH1106_I2C_DrawBitmap(uint8_t* bitmap, uint8_t x, uint8_t y, uint8_t x_len_bits, uint8_t y_len_bits, uint8_t color)
+static void PUT_FUNCTION_IN_FLASH _sh1106_i2c_gray_arm(void)
 {
-	//DRAW BITMAP OF THE SPECIFIED DIMENSIONS AT SPECIFIED X,Y CORDINATES IN THE SPECIFIED COLOR
-	//BITMAP NEEDS TO BE IN ROW MAJOR FORMAT AND DIMENSIONS NEED TO BE MULTIPLE OF 8 BITS
-	//WITH BITMAP WE WILL DO BOTH PIXEL SETTING AND CLEARNING
+	//WITH THE MSB PLANE ON THE DISPLAY, START ALTERNATING THE PLANES IF ANYTHING IS GRAY
+	//AND THE BUS CLOCK CAN CARRY THE GRAY SPANS AT THE PLANE RATE. OTHERWISE STAY 1 BIT
+
+	_sh1106_i2c_gray_overruns = 0;
+
+	if(_sh1106_i2c_gray_page_mask == 0)
+	{
+		//NOTHING GRAY. NO NEED TO ALTERNATE
+		_sh1106_i2c_gray_degraded = 0;
+		return;
+	}
+
+	if(SH1106_I2C_GrayEstimatePlaneRate(_sh1106_i2c_gray_bus_hz) < _sh1106_i2c_gray_plane_rate)
+	{
+		_sh1106_i2c_gray_degraded = 1;
+		if(_sh1106_i2c_debug)
+		{
+			debug_printf("SH1106 : Gray plane rate not sustainable. Showing 1 bit\n");
+		}
+		return;
+	}
+
+	_sh1106_i2c_gray_degraded = 0;
+	os_timer_arm(&_sh1106_i2c_gray_timer, (1000 / _sh1106_i2c_gray_plane_rate) ? (1000 / _sh1106_i2c_gray_plane_rate) : 1, 1);
+}
+
+static void PUT_FUNCTION_IN_FLASH _sh1106_i2c_gray_invalidate_spans(void)
+{
+	//MARK THE GRAY SPANS DIRTY SO THE NEXT FLUSH SENDS THE MSB PLANE THERE AGAIN
+
+	uint8_t page;
+
+	for(page = 0; page < (SH1106_I2C_OLED_MAX_PAGE + 1); page++)
+	{
+		if(_sh1106_i2c_gray_page_mask & (1 << page))
+		{
+			SH1106_I2C_Invalidate(_sh1106_i2c_gray_span_start[page], page * 8, _sh1106_i2c_gray_span_end[page], page * 8 + 7, SH1106_I2C_INVALIDATE_DEFERRED);
+		}
+	}
+}
+
+static const uint8_t* PUT_FUNCTION_IN_FLASH _sh1106_i2c_font_advance_table(const FONT_INFO* font)
+{
+	//RETURN THE CACHED GLYPH ADVANCE TABLE OF THE FONT, BUILDING IT ON FIRST USE
+	//THE OLDEST ENTRY IS REPLACED WHEN THE CACHE IS FULL
+	//RETURNS NULL IF NO MEMORY (ADVANCES ARE THEN READ FROM THE FONT DIRECTLY)
+
+	uint16_t c;
+	uint8_t i;
+	uint8_t* table;
+
+	for(i = 0; i < SH1106_I2C_TEXT_FONT_CACHE_SIZE; i++)
+	{
+		if(_sh1106_i2c_font_cache_key[i] == font->font_bitmap)
+		{
+			return _sh1106_i2c_font_cache_advance[i];
+		}
+	}
+
+	table = (uint8_t*)os_zalloc(font->end_char - font->start_char + 1);
+	if(table == NULL)
+	{
+		return NULL;
+	}
+	//16 BIT COUNTER SO A FONT COVERING 0 - 255 STILL ENDS
+	for(c = 0; c <= (uint16_t)(font->end_char - font->start_char); c++)
+	{
+		table[c] = font->font_char_descriptors[c][0] * 8;
+	}
+
+	i = _sh1106_i2c_font_cache_next;
+	if(_sh1106_i2c_font_cache_advance[i] != NULL)
+	{
+		os_free(_sh1106_i2c_font_cache_advance[i]);
+	}
+	_sh1106_i2c_font_cache_key[i] = font->font_bitmap;
+	_sh1106_i2c_font_cache_advance[i] = table;
+	_sh1106_i2c_font_cache_next = (i + 1) % SH1106_I2C_TEXT_FONT_CACHE_SIZE;
+
+	return table;
+}
+
+static uint8_t PUT_FUNCTION_IN_FLASH _sh1106_i2c_char_advance(const uint8_t* advance_table, const FONT_INFO* font, uint8_t c)
+{
+	//RETURN THE HORIZONTAL ADVANCE IN PIXELS OF THE CHARACTER IN THE FONT
+	//UNSUPPORTED CHARACTERS ARE DRAWN AS A BLOCK OF SH1106_I2C_TEXT_UNSUPPORTED_CHAR_WIDTH
+
+	if(c < font->start_char || c > font->end_char)
+	{
+		return SH1106_I2C_TEXT_UNSUPPORTED_CHAR_WIDTH;
+	}
+	if(advance_table == NULL)
+	{
+		return font->font_char_descriptors[c - font->start_char][0] * 8;
+	}
+	return advance_table[c - font->start_char];
+}
+
+static void PUT_FUNCTION_IN_FLASH _sh1106_i2c_transpose_8x8(const uint8_t* in, uint8_t* out)
+{
+	//TRANSPOSE AN 8x8 BIT MATRIX : BIT j OF out[i] = BIT i OF in[j]
+	//DONE ON THE WHOLE MATRIX AT ONCE AS TWO 32 BIT WORDS BY SWAPPING 1x1, 2x2 AND 4x4 BLOCKS
+
+	uint32_t lo = in[0] | (in[1] << 8) | (in[2] << 16) | ((uint32_t)in[3] << 24);
+	uint32_t hi = in[4] | (in[5] << 8) | (in[6] << 16) | ((uint32_t)in[7] << 24);
+	uint32_t t;
+
+	t = (lo ^ (lo >> 7)) & 0x00AA00AA;
+	lo ^= t ^ (t << 7);
+	t = (hi ^ (hi >> 7)) & 0x00AA00AA;
+	hi ^= t ^ (t << 7);
+
+	t = (lo ^ (lo >> 14)) & 0x0000CCCC;
+	lo ^= t ^ (t << 14);
+	t = (hi ^ (hi >> 14)) & 0x0000CCCC;
+	hi ^= t ^ (t << 14);
+
+	t = (lo ^ (hi << 4)) & 0xF0F0F0F0;
+	lo ^= t;
+	hi ^= (t >> 4);
+
+	out[0] = lo;
+	out[1] = lo >> 8;
+	out[2] = lo >> 16;
+	out[3] = lo >> 24;
+	out[4] = hi;
+	out[5] = hi >> 8;
+	out[6] = hi >> 16;
+	out[7] = hi >> 24;
+}
+
+static uint8_t PUT_FUNCTION_IN_FLASH _sh1106_i2c_draw_char(uint8_t c, uint16_t x, uint16_t y, const FONT_INFO* font, uint8_t color)
+{
+	//DRAW A SINGLE CHARACTER WITH ITS TOP LEFT AT x,y
+	//RETURNS THE HORIZONTAL ADVANCE IN PIXELS
 
+	//GET FONT HEGHT
+	//ONLY FONTS WITH COMMON HEIGHT SUPPORTED
+	uint16_t font_height_bits = font->font_char_descriptors[0][1];
+	uint16_t char_width_bytes;
 	uint16_t x_offset = x;
 	uint16_t y_offset = y;
-	uint8_t byte;
-	uint8_t not_color;
-
-	uint16_t row_size_bytes = (x_len_bits / 8);
+	uint16_t i;
 
-	if(color == 0)
+	if(c < font->start_char || c > font->end_char)
 	{
-		not_color = 1;
+		//CHARACTER IS NOT SUPPORTED BY SPECIFIED FONT
+		//DRAW A BLOCK 8 BITS WIDE AND HEIGHT OF THE FONT IN CHARACTERS PLACE
+
+		if((x > SH1106_I2C_OLED_MAX_COLUMN) || (y > (SH1106_I2C_OLED_MAX_PAGE * 8 + 7)))
+		{
+			//STARTS OFF SCREEN. ONLY ADVANCE
+			return SH1106_I2C_TEXT_UNSUPPORTED_CHAR_WIDTH;
+		}
+
+		while((y_offset < (y + font_height_bits)) && (y_offset <= (SH1106_I2C_OLED_MAX_PAGE * 8 + 7)))
+		{
+			SH1106_I2C_DrawLineHorizontal(x_offset, x_offset + (SH1106_I2C_TEXT_UNSUPPORTED_CHAR_WIDTH - 1), y_offset, color);
+			y_offset += 1;
+		}
+		return SH1106_I2C_TEXT_UNSUPPORTED_CHAR_WIDTH;
 	}
-	else
+
+	//CHARACTER SUPPORTED BY THE FONT
+	char_width_bytes = (font->font_char_descriptors[c - font->start_char][0]);
+
+	if((x > SH1106_I2C_OLED_MAX_COLUMN) || (y > (SH1106_I2C_OLED_MAX_PAGE * 8 + 7)))
 	{
-		not_color = 0;
+		//STARTS OFF SCREEN. ONLY ADVANCE
+		return (char_width_bytes * 8);
 	}
 
-	while(y_offset < (y + y_len_bits))
+	while((y_offset < (y + font_height_bits)) && (y_offset <= (SH1106_I2C_OLED_MAX_PAGE * 8 + 7)))
 	{
-		while(x_offset < (x + x_len_bits))
+		for(i = 0; i < char_width_bytes; i++)
 		{
-			//GET A NEW BYTE FROM BUFFER IF BITS TRAVERSED IN CURRENT ROW EXCEEDS 8
-			if(((x_offset - x) % 8) == 0)
-			{
-				byte = bitmap[(row_size_bytes * (y_offset - y)) + ((x_offset - x) / 8)];
-			}
+			uint8_t byte = font->font_bitmap[font->font_char_descriptors[c - font->start_char][2] + (char_width_bytes * (y_offset - y)) + i];
 
-			//DRAW THE PIXEL IF REQUIRED
 			if(byte & 0x80)
 			{
 				SH1106_I2C_DrawPixel(x_offset, y_offset, color);
 			}
-			else
-			{
-				SH1106_I2C_DrawPixel(x_offset, y_offset, not_color);
-			}
 			x_offset++;
 			if(byte & 0x40)
 			{
 				SH1106_I2C_DrawPixel(x_offset, y_offset, color);
 			}
-			else
-			{
-				SH1106_I2C_DrawPixel(x_offset, y_offset, not_color);
-			}
 			x_offset++;
 			if(byte & 0x20)
 			{
 				SH1106_I2C_DrawPixel(x_offset, y_offset, color);
 			}
-			else
-			{
-				SH1106_I2C_DrawPixel(x_offset, y_offset, not_color);
-			}
 			x_offset++;
 			if(byte & 0x10)
 			{
 				SH1106_I2C_DrawPixel(x_offset, y_offset, color);
 			}
-			else
-			{
-				SH1106_I2C_DrawPixel(x_offset, y_offset, not_color);
-			}
 			x_offset++;
 			if(byte & 0x08)
 			{
 				SH1106_I2C_DrawPixel(x_offset, y_offset, color);
 			}
-			else
-			{
-				SH1106_I2C_DrawPixel(x_offset, y_offset, not_color);
-			}
 			x_offset++;
 			if(byte & 0x04)
 			{
 				SH1106_I2C_DrawPixel(x_offset, y_offset, color);
 			}
-			else
-			{
-				SH1106_I2C_DrawPixel(x_offset, y_offset, not_color);
-			}
 			x_offset++;
 			if(byte & 0x02)
 			{
 				SH1106_I2C_DrawPixel(x_offset, y_offset, color);
 			}
-			else
-			{
-				SH1106_I2C_DrawPixel(x_offset, y_offset, not_color);
-			}
 			x_offset++;
 			if(byte & 0x01)
 			{
 				SH1106_I2C_DrawPixel(x_offset, y_offset, color);
 			}
-			else
-			{
-				SH1106_I2C_DrawPixel(x_offset, y_offset, not_color);
-			}
 			x_offset++;
 		}
-		//RESET x_offset
-		x_offset = x;
+		x_offset -= (char_width_bytes * 8);
 		y_offset++;
 	}
+	return (char_width_bytes * 8);
+}
 
-	if(_sh1106_i2c_debug)
+static uint8_t PUT_FUNCTION_IN_FLASH _sh1106_i2c_image_import_frames(const uint8_t* const* frames, uint16_t frame_count, uint16_t width, uint16_t height, uint16_t stride, uint8_t bytes_per_pixel, uint8_t mode, uint8_t threshold, uint8_t* dest, uint16_t dest_width)
+{
+	//ALLOCATE THE WORKING BUFFERS ONCE AND IMPORT ALL THE FRAMES
+	//FRAME n IS WRITTEN AT dest + n * dest_width * PAGES
+	//RETURNS 1 ON SUCCESS, 0 IF THE WORKING BUFFERS COULD NOT BE ALLOCATED
+
+	uint8_t* luma_rows = NULL;
+	int16_t* error_rows = NULL;
+	uint32_t frame_size = (uint32_t)dest_width * ((height + 7) / 8);
+	uint16_t frame;
+	uint8_t result = 0;
+
+	//RGB IMAGES ARE CONVERTED TO LUMA 8 ROWS (ONE PAGE) AT A TIME
+	//FLOYD-STEINBERG CARRIES THE ERROR OF THE CURRENT AND NEXT ROW
+	if(bytes_per_pixel != SH1106_I2C_IMAGE_GRAY)
 	{
-		debug_printf("SH1106 : Bitmap written of size %u bits\n", (x_len_bits * y_len_bits));
+		luma_rows = (uint8_t*)os_zalloc(8 * width);
+	}
+	if(mode == SH1106_I2C_DITHER_FLOYD_STEINBERG)
+	{
+		error_rows = (int16_t*)os_zalloc(2 * (width + 2) * sizeof(int16_t));
+	}
+
+	if(((bytes_per_pixel == SH1106_I2C_IMAGE_GRAY) || (luma_rows != NULL)) &&
+		((mode != SH1106_I2C_DITHER_FLOYD_STEINBERG) || (error_rows != NULL)))
+	{
+		result = 1;
+		for(frame = 0; frame < frame_count; frame++)
+		{
+			_sh1106_i2c_image_import(frames[frame], width, height, stride, bytes_per_pixel, mode, threshold, &dest[frame * frame_size], dest_width, luma_rows, error_rows);
+		}
+	}
+
+	if(luma_rows != NULL)
+	{
+		os_free(luma_rows);
+	}
+	if(error_rows != NULL)
+	{
+		os_free(error_rows);
+	}
+	return result;
+}
+
+static void PUT_FUNCTION_IN_FLASH _sh1106_i2c_image_import(const uint8_t* image, uint16_t width, uint16_t height, uint16_t stride, uint8_t bytes_per_pixel, uint8_t mode, uint8_t threshold, uint8_t* dest, uint16_t dest_width, uint8_t* luma_rows, int16_t* error_rows)
+{
+	//CONVERT ONE IMAGE INTO PAGE MAJOR FORMAT, ONE PAGE (8 ROWS) AT A TIME
+	//luma_rows (8 * width) IS NEEDED FOR RGB, error_rows (2 * (width + 2)) FOR FLOYD-STEINBERG
+
+	const uint8_t* rows[8];
+	uint8_t thresholds[8][16];
+	uint16_t page;
+	uint16_t x;
+	uint8_t r;
+	uint8_t row_count;
+	const uint8_t* src;
+	int16_t* error_current;
+	int16_t* error_next;
+	int16_t* error_swap;
+	int16_t value;
+	int16_t error;
+	int16_t level;
+
+	if(mode == SH1106_I2C_DITHER_FLOYD_STEINBERG)
+	{
+		os_memset(error_rows, 0, 2 * (width + 2) * sizeof(int16_t));
+	}
+	error_current = error_rows;
+	error_next = error_rows + (width + 2);
+
+	for(page = 0; page < ((height + 7) / 8); page++)
+	{
+		row_count = ((height - (page * 8)) < 8) ? (height - (page * 8)) : 8;
+
+		//GET THE LUMA OF THE ROWS OF THIS PAGE
+		for(r = 0; r < row_count; r++)
+		{
+			src = &image[(uint32_t)((page * 8) + r) * stride];
+			if(bytes_per_pixel == SH1106_I2C_IMAGE_GRAY)
+			{
+				rows[r] = src;
+				continue;
+			}
+			for(x = 0; x < width; x++)
+			{
+				//ITU-R BT.601 WEIGHTS IN 8 BIT FIXED POINT
+				luma_rows[(r * width) + x] = ((77 * src[0]) + (150 * src[1]) + (29 * src[2])) >> 8;
+				src += bytes_per_pixel;
+			}
+			rows[r] = &luma_rows[r * width];
+		}
+
+		if(mode != SH1106_I2C_DITHER_FLOYD_STEINBERG)
+		{
+			//THRESHOLD AND ORDERED ARE BOTH A PER PIXEL COMPARE AGAINST A THRESHOLD
+			//PATTERN THAT REPEATS EVERY 4 COLUMNS, SO 16 ENTRIES PER ROW COVER IT
+			for(r = 0; r < 8; r++)
+			{
+				for(x = 0; x < 16; x++)
+				{
+					if(mode == SH1106_I2C_DITHER_ORDERED)
+					{
+						level = (_sh1106_i2c_bayer_4x4[((page * 8) + r) & 3][x & 3] * 16) + 8 + (threshold - 128);
+						thresholds[r][x] = (level < 0) ? 0 : ((level > 255) ? 255 : level);
+					}
+					else
+					{
+						thresholds[r][x] = threshold;
+					}
+				}
+			}
+			_sh1106_i2c_image_pack_page(rows, row_count, thresholds, width, &dest[page * dest_width]);
+			continue;
+		}
+
+		//FLOYD-STEINBERG IS SERIAL ALONG THE ROW SO IT STAYS SCALAR
+		os_memset(&dest[page * dest_width], 0, width);
+		for(r = 0; r < row_count; r++)
+		{
+			for(x = 0; x < width; x++)
+			{
+				value = rows[r][x] + error_current[x + 1];
+				if(value > threshold)
+				{
+					dest[(page * dest_width) + x] |= (1 << r);
+					error = value - 255;
+				}
+				else
+				{
+					error = value;
+				}
+				error_current[x + 2] += (error * 7) / 16;
+				error_next[x] += (error * 3) / 16;
+				error_next[x + 1] += (error * 5) / 16;
+				error_next[x + 2] += error / 16;
+			}
+
+			//NEXT ROW
+			error_swap = error_current;
+			error_current = error_next;
+			error_next = error_swap;
+			os_memset(error_next, 0, (width + 2) * sizeof(int16_t));
+		}
+	}
+}
+
+static void PUT_FUNCTION_IN_FLASH _sh1106_i2c_image_pack_page(const uint8_t* const* rows, uint8_t row_count, uint8_t thresholds[8][16], uint16_t width, uint8_t* dest)
+{
+	//BUILD ONE PAGE OF THE DISPLAY FORMAT FROM UP TO 8 LUMA ROWS
+	//BIT r OF dest[x] IS SET WHEN rows[r][x] > thresholds[r][x % 16]
+	//16 COLUMNS AT A TIME WITH SSE2 / NEON WHEN AVAILABLE, SCALAR OTHERWISE
+
+	uint16_t x = 0;
+	uint8_t r;
+	uint8_t byte;
+
+#if defined(__SSE2__)
+	//SSE2 HAS NO UNSIGNED BYTE COMPARE, SO FLIP THE SIGN BITS AND COMPARE SIGNED
+	const __m128i sign = _mm_set1_epi8((char)0x80);
+	__m128i limit[8];
+	__m128i acc;
+	__m128i pixels;
+
+	for(r = 0; r < row_count; r++)
+	{
+		limit[r] = _mm_xor_si128(_mm_loadu_si128((const __m128i*)thresholds[r]), sign);
+	}
+	for(; (x + 16) <= width; x += 16)
+	{
+		acc = _mm_setzero_si128();
+		for(r = 0; r < row_count; r++)
+		{
+			pixels = _mm_xor_si128(_mm_loadu_si128((const __m128i*)&rows[r][x]), sign);
+			acc = _mm_or_si128(acc, _mm_and_si128(_mm_cmpgt_epi8(pixels, limit[r]), _mm_set1_epi8((char)(1 << r))));
+		}
+		_mm_storeu_si128((__m128i*)&dest[x], acc);
+	}
+#elif defined(__ARM_NEON)
+	uint8x16_t limit[8];
+	uint8x16_t acc;
+
+	for(r = 0; r < row_count; r++)
+	{
+		limit[r] = vld1q_u8(thresholds[r]);
+	}
+	for(; (x + 16) <= width; x += 16)
+	{
+		acc = vdupq_n_u8(0);
+		for(r = 0; r < row_count; r++)
+		{
+			acc = vorrq_u8(acc, vandq_u8(vcgtq_u8(vld1q_u8(&rows[r][x]), limit[r]), vdupq_n_u8(1 << r)));
+		}
+		vst1q_u8(&dest[x], acc);
+	}
+#endif
+
+	//SCALAR (AND TAIL OF THE VECTOR LOOP)
+	for(; x < width; x++)
+	{
+		byte = 0;
+		for(r = 0; r < row_count; r++)
+		{
+			if(rows[r][x] > thresholds[r][x & 15])
+			{
+				byte |= (1 << r);
+			}
+		}
+		dest[x] = byte;
 	}
 }
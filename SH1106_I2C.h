@@ -42,12 +42,19 @@
 	#include "gpio.h"
 	#include "os_type.h"
 	#include "mem.h"
+	#include "user_interface.h"
 
 	#define PUT_FUNCTION_IN_FLASH 				ICACHE_FLASH_ATTR
 	#define _sh1106_i2c_backend_init			ESP8266_I2C_Init
 	#define	 _sh1106_i2c_send_start_function	ESP8266_I2C_SendStart
 	#define _sh1106_i2c_send_stop_function		ESP8266_I2C_SendStop
+	//RETURNS NON 0 WHEN THE SLAVE ACKS THE BYTE
 	#define _sh1106_i2c_send_byte_function		ESP8266_I2C_SendByte
+	#ifdef SH1106_I2C_DIRECT_MODE
+		//DIRECT MODE READS THE DISPLAY RAM BACK, SO THE BACKEND MUST SUPPORT BUS READS
+		//ARGUMENT = 1 TO ACK THE BYTE, 0 TO NACK IT (LAST BYTE)
+		#define _sh1106_i2c_read_byte_function	ESP8266_I2C_ReadByte
+	#endif
 	#define debug_printf 						os_printf
 #else
 	#define PUT_FUNCTION_IN_FLASH
@@ -58,8 +65,21 @@
 #define SH1106_I2C_ADDRESS_2						0x3D
 
 //SCREEN PIXEL SIZE
-#define SH1106_I2C_OLED_MAX_COLUMN					127u
-#define SH1106_I2C_OLED_MAX_PAGE					7u
+//CAN BE OVERRIDDEN FROM THE BUILD FOR OTHER PANELS (EG 128x32 : MAX_PAGE = 3, COM PADS = 0x02)
+//SEE SH1106_I2C.hpp FOR THE C++ FRONT END SPECIALIZED PER PANEL AT COMPILE TIME
+#ifndef SH1106_I2C_OLED_MAX_COLUMN
+	#define SH1106_I2C_OLED_MAX_COLUMN				127u
+#endif
+#ifndef SH1106_I2C_OLED_MAX_PAGE
+	#define SH1106_I2C_OLED_MAX_PAGE				7u
+#endif
+#ifndef SH1106_I2C_OLED_COM_PADS_CONFIG
+	#define SH1106_I2C_OLED_COM_PADS_CONFIG			0x12
+#endif
+#define SH1106_I2C_OLED_MULTIPLEX_RATIO				(((SH1106_I2C_OLED_MAX_PAGE + 1) * 8) - 1)
+
+//CONTRAST SET BY THE INIT STREAM
+#define SH1106_I2C_DEFAULT_CONTRAST					0x7F
 
 //CONTROL BYTES
 #define SH1106_I2C_CONTROL_BYTE_CMD_SINGLE			0x80
@@ -96,20 +116,216 @@
 #define SH1106_I2C_SCREEN_FILL_PATTERN_CLEAR		0x00
 #define SH1106_I2C_SCREEN_FILL_PATTERN_FILL			0xFF
 
+//COLUMN IN THE 132 COLUMN DISPLAY RAM WHERE THE OLED COLUMN 0 STARTS
+#define SH1106_I2C_RAM_COLUMNS						132u
+#ifndef SH1106_I2C_OLED_COLUMN_OFFSET
+	#define SH1106_I2C_OLED_COLUMN_OFFSET			0u
+#endif
+
+//ORIENTATION (DONE IN HARDWARE WITH SEGMENT REMAP AND COM SCAN DIRECTION)
+#define SH1106_I2C_ORIENTATION_ROTATE_0				0x00
+#define SH1106_I2C_ORIENTATION_FLIP_HORIZONTAL		0x01
+#define SH1106_I2C_ORIENTATION_FLIP_VERTICAL		0x02
+#define SH1106_I2C_ORIENTATION_ROTATE_180			0x03
+
+//PORTRAIT ROTATION (DONE IN SOFTWARE WITH 8x8 BIT TRANSPOSES)
+#define SH1106_I2C_ROTATION_90						90u
+#define SH1106_I2C_ROTATION_270						270u
+
+//REFRESH SCHEDULER
+#define SH1106_I2C_SCHEDULER_DEFAULT_FRAME_INTERVAL_MS	40u
+#define SH1106_I2C_INVALIDATE_DEFERRED				0u
+#define SH1106_I2C_INVALIDATE_URGENT				1u
+
+typedef struct
+{
+	uint32_t invalidate_requests;	//TOTAL INVALIDATE REQUESTS RECEIVED
+	uint32_t merged_updates;		//REQUESTS FOLDED INTO AN ALREADY PENDING FLUSH
+	uint32_t dropped_updates;		//REQUESTS FULLY COVERED BY THE PENDING DIRTY AREA
+	uint32_t scheduled_flushes;		//FLUSHES DONE ON THE FRAME TIMER
+	uint32_t urgent_flushes;		//FLUSHES DONE IMMEDIATELY FOR URGENT REQUESTS
+} SH1106_I2C_SCHEDULER_STATS;
+
+//ACK CHECKED TRANSPORT
+//A TRANSACTION FAILS WHEN ANY OF ITS BYTES IS NACKED. A FAILED PAGE TRANSFER IS RETRIED ON
+//ITS OWN (NOT THE WHOLE FRAME, NO REINIT) WITH A DOUBLING BACKOFF. IF IT STILL FAILS THE PAGE
+//IS MARKED SUSPECT AND LEFT DIRTY, SO THE NEXT FLUSH RESENDS ONLY THAT PAGE
+#define SH1106_I2C_TRANSPORT_MAX_RETRIES			3u
+#define SH1106_I2C_TRANSPORT_BACKOFF_US				100u
+#define SH1106_I2C_TRANSPORT_BACKOFF_MAX_US			1000u
+
+typedef struct
+{
+	uint32_t transactions;			//I2C TRANSACTIONS ENDED
+	uint32_t failed_transactions;	//TRANSACTIONS WITH A NACKED BYTE
+	uint32_t page_transfers;		//PAGE (SPAN) TRANSFERS REQUESTED
+	uint32_t page_retries;			//PAGE TRANSFER RETRIES
+	uint32_t pages_recovered;		//PAGE TRANSFERS THAT WENT THROUGH ON A RETRY
+	uint32_t pages_failed;			//PAGE TRANSFERS THAT RAN OUT OF RETRIES (PAGE MARKED SUSPECT)
+} SH1106_I2C_TRANSPORT_STATS;
+
+//EFFECTS ENGINE
+#define SH1106_I2C_EFFECT_MAX_STEPS					64u
+#define SH1106_I2C_EFFECT_MAX_STEP_COMMANDS			2u
+
+typedef struct
+{
+	uint8_t command_count;
+	uint8_t commands[SH1106_I2C_EFFECT_MAX_STEP_COMMANDS];
+	uint16_t delay_ms;		//DELAY BEFORE THE NEXT STEP. 0 = BATCH WITH THE NEXT STEP
+} SH1106_I2C_EFFECT_STEP;
+
+typedef void (*SH1106_I2C_EFFECT_DONE_CALLBACK)(void);
+
+//WARM RESUME AFTER DEEP SLEEP
+//THE PANEL KEEPS ITS REGISTERS AND DISPLAY RAM WHILE POWERED, SO ONLY A SMALL RECORD OF THE
+//CONTROLLER STATE AND PER SEGMENT FRAMEBUFFER CHECKSUMS IS KEPT IN THE ESP8266 RTC MEMORY
+//RTC USER MEMORY BLOCK (4 BYTES EACH, 64 - 191) WHERE THE RECORD STARTS
+#ifndef SH1106_I2C_RESUME_RTC_MEM_BLOCK
+	#define SH1106_I2C_RESUME_RTC_MEM_BLOCK			64u
+#endif
+#define SH1106_I2C_RESUME_MAGIC						0x53483036
+#define SH1106_I2C_RESUME_SEGMENT_COLUMNS			32u
+#define SH1106_I2C_RESUME_SEGMENTS					((SH1106_I2C_OLED_MAX_COLUMN + 1) / SH1106_I2C_RESUME_SEGMENT_COLUMNS)
+#define SH1106_I2C_RESUME_FLAG_DISPLAY_ON			0x01
+#define SH1106_I2C_RESUME_FLAG_INVERTED				0x02
+
+typedef struct
+{
+	uint32_t magic;
+	uint8_t slave_address;
+	uint8_t contrast;
+	uint8_t orientation;
+	uint8_t flags;
+	uint16_t checksum[SH1106_I2C_OLED_MAX_PAGE + 1][SH1106_I2C_RESUME_SEGMENTS];
+} SH1106_I2C_RESUME_RECORD;
+
+//DIRECT (FRAMEBUFFER LESS) MODE
+//ENABLED WITH SH1106_I2C_DIRECT_MODE. PIXELS ARE UPDATED IN PLACE IN THE DISPLAY RAM WITH THE
+//READ-MODIFY-WRITE COMMAND (READS DO NOT MOVE THE COLUMN, WRITES INCREMENT IT)
+//THERE IS NO FRAMEBUFFER, SO THE FRAMEBUFFER FUNCTIONS (DRAW, TEXT, UPDATE, FLUSH) DO NOTHING
+typedef struct
+{
+	uint32_t bytes_on_wire;				//BYTES ACTUALLY SENT AND READ BY THE DIRECT FUNCTIONS
+	uint32_t shadow_bytes_equivalent;	//BYTES THE SHADOW FRAMEBUFFER PATH WOULD HAVE SENT
+										//FOR THE SAME UPDATES (DIRTY SPAN FLUSH)
+} SH1106_I2C_DIRECT_STATS;
+
+//FRAME STREAMING
+//PRODUCER RETURNS A POINTER TO THE (MAX_COLUMN + 1) BYTES OF THE REQUESTED PAGE, OR NULL TO ABORT
+typedef const uint8_t* (*SH1106_I2C_STREAM_PRODUCER)(uint8_t page, void* arg);
+
+//TEMPORAL DITHER GRAYSCALE
+//2 BIT PIXELS AS TWO BIT PLANES (THE FRAMEBUFFER IS THE MSB PLANE) SHOWN ALTERNATELY, THE LSB
+//PLANE AT HALF CONTRAST. EACH SWITCH SENDS ONLY THE COLUMNS THAT DIFFER BETWEEN THE PLANES
+//PLANE RATES FROM SH1106_I2C_GrayEstimatePlaneRate (I2C BUS ONLY, NO CPU TIME) :
+//	WHOLE SCREEN GRAY (1084 BYTES PER SWITCH)	~40 / s AT 400 kHz, ~102 / s AT 1 MHz
+//	ONE 16 PIXEL TEXT LINE (274 BYTES PER SWITCH)	~161 / s AT 400 kHz, ~403 / s AT 1 MHz
+//BELOW ~60 PLANES / S THE ALTERNATION FLICKERS VISIBLY
+#define SH1106_I2C_GRAY_LEVEL_BLACK					0u
+#define SH1106_I2C_GRAY_LEVEL_DARK					1u
+#define SH1106_I2C_GRAY_LEVEL_LIGHT					2u
+#define SH1106_I2C_GRAY_LEVEL_WHITE					3u
+#define SH1106_I2C_GRAY_DEFAULT_PLANE_RATE_HZ		60u
+//PLANE SWITCHES IN A ROW THAT MAY OVERRUN THEIR SLOT BEFORE FALLING BACK TO 1 BIT
+#define SH1106_I2C_GRAY_MAX_OVERRUNS				3u
+
+//IMAGE IMPORT
+#define SH1106_I2C_IMAGE_GRAY						1u
+#define SH1106_I2C_IMAGE_RGB						3u
+#define SH1106_I2C_DITHER_THRESHOLD					0u
+#define SH1106_I2C_DITHER_ORDERED					1u
+#define SH1106_I2C_DITHER_FLOYD_STEINBERG			2u
+
+//TEXT LAYOUT
+#define SH1106_I2C_TEXT_ALIGN_LEFT					0x00
+#define SH1106_I2C_TEXT_ALIGN_CENTER				0x01
+#define SH1106_I2C_TEXT_ALIGN_RIGHT					0x02
+#define SH1106_I2C_TEXT_ALIGN_JUSTIFY				0x03
+#define SH1106_I2C_TEXT_ALIGN_MASK					0x03
+#define SH1106_I2C_TEXT_WRAP						0x04
+#define SH1106_I2C_TEXT_ELLIPSIS					0x08
+
+#define SH1106_I2C_TEXT_MAX_LINES					8u
+#define SH1106_I2C_TEXT_FONT_CACHE_SIZE				4u
+#define SH1106_I2C_TEXT_UNSUPPORTED_CHAR_WIDTH		8u
+
+typedef struct
+{
+	uint16_t start;					//INDEX OF THE FIRST CHARACTER OF THE LINE IN THE STRING
+	uint16_t length;				//NUMBER OF CHARACTERS ON THE LINE
+	uint16_t width;					//LINE WIDTH IN PIXELS (WITHOUT JUSTIFICATION OR ELLIPSIS)
+	uint8_t x_offset;				//ALIGNMENT OFFSET FROM THE LEFT OF THE BOX
+	uint8_t space_extra;			//EXTRA PIXELS AFTER EVERY SPACE (JUSTIFY)
+	uint8_t space_extra_remainder;	//NUMBER OF LEADING SPACES GETTING ONE MORE PIXEL (JUSTIFY)
+	uint8_t ellipsis;				//1 IF "..." FOLLOWS THE LINE
+} SH1106_I2C_TEXT_SPAN;
+
+//TEXT FIELD
+//REMEMBERS THE LAST STRING DRAWN SO THAT ONLY THE CHANGED CHARACTERS ARE REDRAWN
+#define SH1106_I2C_TEXT_FIELD_MAX_CHARS				24u
+
+typedef struct
+{
+	uint8_t x;
+	uint8_t y;
+	uint8_t color;
+	uint8_t length;
+	FONT_INFO font;
+	char text[SH1106_I2C_TEXT_FIELD_MAX_CHARS + 1];
+} SH1106_I2C_TEXT_FIELD;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 //FUNCTION PROTOTYPES/////////////////////////////////////
 //CONFIGURATION FUNCTIONS
 void PUT_FUNCTION_IN_FLASH SH1106_I2C_SetDebug(uint8_t debug_on);
 void PUT_FUNCTION_IN_FLASH SH1106_I2C_SetDeviceAddress(uint8_t address);
-void PUT_FUNCTION_IN_FLASH SH1106_I2C_Init(void);
+uint8_t PUT_FUNCTION_IN_FLASH SH1106_I2C_Init(void);
 
 //CONTROL FUNCTIONS
-void PUT_FUNCTION_IN_FLASH SH1106_I2C_SetDisplayOnOff(uint8_t on);
-void PUT_FUNCTION_IN_FLASH SH1106_I2C_SetDisplayContrast(uint8_t contrast_val);
-void PUT_FUNCTION_IN_FLASH SH1106_I2C_SetDisplayNormal(void);
-void PUT_FUNCTION_IN_FLASH SH1106_I2C_SetDisplayInverted(void);
+uint8_t PUT_FUNCTION_IN_FLASH SH1106_I2C_SetDisplayOnOff(uint8_t on);
+uint8_t PUT_FUNCTION_IN_FLASH SH1106_I2C_SetDisplayContrast(uint8_t contrast_val);
+uint8_t PUT_FUNCTION_IN_FLASH SH1106_I2C_SetDisplayNormal(void);
+uint8_t PUT_FUNCTION_IN_FLASH SH1106_I2C_SetDisplayInverted(void);
+uint8_t PUT_FUNCTION_IN_FLASH SH1106_I2C_SetOrientation(uint8_t orientation);
 void PUT_FUNCTION_IN_FLASH SH1106_I2C_ResetAndClearScreen(const uint8_t* fill_pattern, uint8_t len);
 void PUT_FUNCTION_IN_FLASH SH1106_I2C_UpdateDisplay(void);
 
+//WARM RESUME FUNCTIONS
+void PUT_FUNCTION_IN_FLASH SH1106_I2C_PrepareDeepSleep(uint8_t display_off);
+uint8_t PUT_FUNCTION_IN_FLASH SH1106_I2C_WarmResume(void);
+uint8_t PUT_FUNCTION_IN_FLASH SH1106_I2C_ResumeFlush(void);
+
+//REFRESH SCHEDULER FUNCTIONS
+void PUT_FUNCTION_IN_FLASH SH1106_I2C_SchedulerStart(uint16_t frame_interval_ms);
+void PUT_FUNCTION_IN_FLASH SH1106_I2C_SchedulerStop(void);
+void PUT_FUNCTION_IN_FLASH SH1106_I2C_Invalidate(uint8_t x_start, uint8_t y_start, uint8_t x_end, uint8_t y_end, uint8_t urgent);
+void PUT_FUNCTION_IN_FLASH SH1106_I2C_InvalidateAll(uint8_t urgent);
+void PUT_FUNCTION_IN_FLASH SH1106_I2C_FlushDirty(void);
+void PUT_FUNCTION_IN_FLASH SH1106_I2C_SchedulerGetStats(SH1106_I2C_SCHEDULER_STATS* stats);
+void PUT_FUNCTION_IN_FLASH SH1106_I2C_SchedulerResetStats(void);
+
+//TRANSPORT FUNCTIONS
+void PUT_FUNCTION_IN_FLASH SH1106_I2C_TransportGetStats(SH1106_I2C_TRANSPORT_STATS* stats);
+void PUT_FUNCTION_IN_FLASH SH1106_I2C_TransportResetStats(void);
+uint8_t PUT_FUNCTION_IN_FLASH SH1106_I2C_GetSuspectPages(void);
+uint8_t PUT_FUNCTION_IN_FLASH SH1106_I2C_SendCommands(const uint8_t* commands, uint8_t command_count);
+uint8_t PUT_FUNCTION_IN_FLASH SH1106_I2C_SendPageData(uint8_t page, uint8_t ram_column, const uint8_t* data, uint16_t len);
+
+//EFFECTS ENGINE FUNCTIONS
+void PUT_FUNCTION_IN_FLASH SH1106_I2C_EffectClear(void);
+uint8_t PUT_FUNCTION_IN_FLASH SH1106_I2C_EffectAppendStep(const uint8_t* commands, uint8_t command_count, uint16_t delay_ms);
+uint8_t PUT_FUNCTION_IN_FLASH SH1106_I2C_EffectAppendFade(uint8_t contrast_from, uint8_t contrast_to, uint8_t steps, uint16_t step_ms);
+uint8_t PUT_FUNCTION_IN_FLASH SH1106_I2C_EffectAppendBlink(uint8_t count, uint16_t period_ms);
+uint8_t PUT_FUNCTION_IN_FLASH SH1106_I2C_EffectAppendPulse(uint8_t count, uint16_t on_ms, uint16_t off_ms);
+uint16_t PUT_FUNCTION_IN_FLASH SH1106_I2C_EffectGetBusBytes(void);
+void PUT_FUNCTION_IN_FLASH SH1106_I2C_EffectStart(uint8_t repeat, SH1106_I2C_EFFECT_DONE_CALLBACK done_cb);
+void PUT_FUNCTION_IN_FLASH SH1106_I2C_EffectStop(void);
+uint8_t PUT_FUNCTION_IN_FLASH SH1106_I2C_EffectIsRunning(void);
+
 //DRAWING FUNCTIONS
 void PUT_FUNCTION_IN_FLASH SH1106_I2C_DrawPixel(uint8_t x, uint8_t y, uint8_t color);
 void PUT_FUNCTION_IN_FLASH SH1106_I2C_DrawLineVertical(uint8_t x, uint8_t y_start, uint8_t y_end, uint8_t color);
@@ -119,8 +335,50 @@ void PUT_FUNCTION_IN_FLASH SH1106_I2C_DrawBoxFilled(uint8_t x_start, uint8_t y_s
 void PUT_FUNCTION_IN_FLASH SH1106_I2C_DrawCircleEmpty(int8_t x, int8_t y, int8_t radius, uint8_t color);
 void PUT_FUNCTION_IN_FLASH SH1106_I2C_DrawCircleFilled(int8_t x, int8_t y, int8_t radius, uint8_t color);
 
+#ifdef SH1106_I2C_DIRECT_MODE
+//DIRECT MODE FUNCTIONS
+uint8_t PUT_FUNCTION_IN_FLASH SH1106_I2C_DirectInit(void);
+uint8_t PUT_FUNCTION_IN_FLASH SH1106_I2C_DirectDrawPixel(uint8_t x, uint8_t y, uint8_t color);
+uint8_t PUT_FUNCTION_IN_FLASH SH1106_I2C_DirectDrawLineHorizontal(uint8_t x_start, uint8_t x_end, uint8_t y, uint8_t color);
+uint8_t PUT_FUNCTION_IN_FLASH SH1106_I2C_DirectDrawLineVertical(uint8_t x, uint8_t y_start, uint8_t y_end, uint8_t color);
+uint8_t PUT_FUNCTION_IN_FLASH SH1106_I2C_DirectDrawBoxFilled(uint8_t x_start, uint8_t y_start, uint8_t x_end, uint8_t y_end, uint8_t color);
+void PUT_FUNCTION_IN_FLASH SH1106_I2C_DirectGetStats(SH1106_I2C_DIRECT_STATS* stats);
+void PUT_FUNCTION_IN_FLASH SH1106_I2C_DirectResetStats(void);
+#endif
+
+//FRAME STREAMING FUNCTIONS
+uint8_t PUT_FUNCTION_IN_FLASH SH1106_I2C_StreamFrame(const uint8_t* frame);
+uint8_t PUT_FUNCTION_IN_FLASH SH1106_I2C_StreamFromProducer(SH1106_I2C_STREAM_PRODUCER producer, void* arg);
+
+//GRAYSCALE FUNCTIONS
+uint8_t PUT_FUNCTION_IN_FLASH SH1106_I2C_GrayStart(uint8_t plane_rate_hz, uint32_t bus_hz);
+void PUT_FUNCTION_IN_FLASH SH1106_I2C_GrayStop(void);
+void PUT_FUNCTION_IN_FLASH SH1106_I2C_GrayClear(void);
+void PUT_FUNCTION_IN_FLASH SH1106_I2C_GrayDrawPixel(uint8_t x, uint8_t y, uint8_t level);
+void PUT_FUNCTION_IN_FLASH SH1106_I2C_GrayDrawBitmap(const uint8_t* bitmap, uint8_t x, uint8_t y, uint8_t width, uint8_t height);
+void PUT_FUNCTION_IN_FLASH SH1106_I2C_GrayUpdate(void);
+uint16_t PUT_FUNCTION_IN_FLASH SH1106_I2C_GrayEstimatePlaneRate(uint32_t bus_hz);
+uint8_t PUT_FUNCTION_IN_FLASH SH1106_I2C_GrayIsDegraded(void);
+
+//IMAGE IMPORT FUNCTIONS
+uint8_t PUT_FUNCTION_IN_FLASH SH1106_I2C_ImageImport(const uint8_t* image, uint16_t width, uint16_t height, uint16_t stride, uint8_t bytes_per_pixel, uint8_t mode, uint8_t threshold, uint8_t* dest, uint16_t dest_width);
+uint8_t PUT_FUNCTION_IN_FLASH SH1106_I2C_ImageImportToFramebuffer(const uint8_t* image, uint16_t width, uint16_t height, uint16_t stride, uint8_t bytes_per_pixel, uint8_t mode, uint8_t threshold);
+uint8_t PUT_FUNCTION_IN_FLASH SH1106_I2C_ImageImportSequence(const uint8_t* const* frames, uint16_t frame_count, uint16_t width, uint16_t height, uint16_t stride, uint8_t bytes_per_pixel, uint8_t mode, uint8_t threshold, uint8_t* dest);
+
+//TEXT LAYOUT FUNCTIONS
+uint16_t PUT_FUNCTION_IN_FLASH SH1106_I2C_MeasureString(const char* str, const FONT_INFO font);
+uint8_t PUT_FUNCTION_IN_FLASH SH1106_I2C_LayoutText(const char* str, const FONT_INFO font, uint8_t box_width, uint8_t max_lines, uint8_t flags, SH1106_I2C_TEXT_SPAN* spans);
+
 //COMPLEX DRAWING FUNCTIONS
 void PUT_FUNCTION_IN_FLASH SH1106_I2C_DrawString(char* str, uint8_t x, uint8_t y, const FONT_INFO font, uint8_t color);
+void PUT_FUNCTION_IN_FLASH SH1106_I2C_DrawTextBox(const char* str, uint8_t x, uint8_t y, uint8_t box_width, uint8_t box_height, const FONT_INFO font, uint8_t flags, uint8_t color);
+void PUT_FUNCTION_IN_FLASH SH1106_I2C_TextFieldInit(SH1106_I2C_TEXT_FIELD* field, uint8_t x, uint8_t y, const FONT_INFO font, uint8_t color);
+uint8_t PUT_FUNCTION_IN_FLASH SH1106_I2C_TextFieldSet(SH1106_I2C_TEXT_FIELD* field, const char* str);
 void PUT_FUNCTION_IN_FLASH SH1106_I2C_DrawBitmap(uint8_t* bitmap, uint8_t x, uint8_t y, uint8_t x_len_bits, uint8_t y_len_bits, uint8_t color);
+uint8_t PUT_FUNCTION_IN_FLASH SH1106_I2C_DrawPortraitFrame(const uint8_t* portrait, uint16_t rotation);
 //END FUNCTION PROTOTYPES/////////////////////////////////
+
+#ifdef __cplusplus
+}
+#endif
 #endif
@@ -0,0 +1,209 @@
+/****************************************************************
+* SH1106 BASED OLED MODULE
+* I2C MODE
+* C++ FRONT END SPECIALIZED PER PANEL GEOMETRY AT COMPILE TIME
+*
+* NOTE: THE C DRIVER (SH1106_I2C.h) IS FIXED TO ONE PANEL GEOMETRY
+* 		PER BUILD. THIS TEMPLATE TAKES THE WIDTH, HEIGHT, RAM COLUMN
+* 		OFFSET AND COM PADS CONFIGURATION AS TEMPLATE PARAMETERS, SO
+* 		THE BUFFER SIZE, PIXEL INDEX MATH AND INIT COMMAND TABLE ARE
+* 		ALL WORKED OUT BY THE COMPILER. PIXEL INDEXING IS SHIFTS AND
+* 		MASKS ONLY (NO RUNTIME DIVIDE / MODULO)
+*
+* 		ALL TRANSFERS GO THROUGH THE ACK CHECKED TRANSPORT OF THE C
+* 		DRIVER (PER PAGE RETRIES, SH1106_I2C_TransportGetStats) AND
+* 		USE ITS DEVICE ADDRESS. ONE PANEL SHOULD ONLY BE DRIVEN
+* 		THROUGH ONE OF THE TWO APIS
+*
+* 		EXAMPLE
+* 			static SH1106_I2C_PANEL_128X32 oled;
+* 			oled.Init(SH1106_I2C_ADDRESS_1);
+* 			oled.DrawPixel(10, 10, 1);
+* 			oled.UpdateDisplay();
+*
+* ANKIT BHATNAGAR
+* ANKIT.BHATNAGARINDIA@GMAIL.COM
+****************************************************************/
+
+#ifndef _SH1106_I2C_HPP_
+#define _SH1106_I2C_HPP_
+
+#include "SH1106_I2C.h"
+
+template<uint8_t WIDTH, uint8_t HEIGHT, uint8_t COLUMN_OFFSET = SH1106_I2C_OLED_COLUMN_OFFSET, uint8_t COM_PADS_CONFIG = SH1106_I2C_OLED_COM_PADS_CONFIG>
+class SH1106_I2C_PANEL
+{
+	static_assert((WIDTH > 0) && ((WIDTH + COLUMN_OFFSET) <= SH1106_I2C_RAM_COLUMNS), "SH1106 : panel does not fit the 132 column display RAM");
+	static_assert((HEIGHT > 0) && (HEIGHT <= 64) && ((HEIGHT % 8) == 0), "SH1106 : panel height must be a multiple of 8, at most 64");
+
+	public:
+		static constexpr uint8_t PAGES = HEIGHT / 8;
+		static constexpr uint16_t BUFFER_SIZE = (uint16_t)WIDTH * PAGES;
+
+		//INIT COMMAND STREAM (SAME SEQUENCE AS SH1106_I2C_Init) WITH THE
+		//GEOMETRY DEPENDENT VALUES FILLED IN BY THE COMPILER
+		static constexpr uint8_t INIT_TABLE[] =
+		{
+			SH1106_I2C_CMD_SET_DISPLAY_OFF,
+			SH1106_I2C_CMD_SET_COLUMN_LOWER_4 | (COLUMN_OFFSET & 0x0F),
+			SH1106_I2C_CMD_SET_COLUMN_UPPER_4 | (COLUMN_OFFSET >> 4),
+			SH1106_I2C_CMD_SET_PAGE_ADDRESS | 0,
+			SH1106_I2C_CMD_SET_COMMON_SCAN_DIRECTION | 8,
+			SH1106_I2C_CMD_SET_DISPLAY_START_LINE | 0,
+			SH1106_I2C_CMD_SET_CONTRAST_CONTROL_MODE, SH1106_I2C_DEFAULT_CONTRAST,
+			SH1106_I2C_CMD_SET_SEGMENT_REMAP | 1,
+			SH1106_I2C_CMD_SET_DISPLAY_NORMAL,
+			SH1106_I2C_CMD_SET_MULTIPLEX_RATIO, HEIGHT - 1,
+			SH1106_I2C_CMD_SET_ENTIRE_DISPLAY_ON,
+			SH1106_I2C_CMD_SET_DISPLAY_OFFSET_MODE, 0x00,
+			SH1106_I2C_CMD_SET_OSCILLATOR_FREQUENCY, 0xF0,
+			SH1106_I2C_CMD_SET_DISCHARGE_PRECHARGE, 0x22,
+			SH1106_I2C_CMD_COMMON_PADS_HARDWARE_CONFIG, COM_PADS_CONFIG,
+			SH1106_I2C_CMD_COMMON_PADS_OUTPUT_VOLTAGE, 0x20,
+			0x8D, 0x14,
+			SH1106_I2C_CMD_SET_DISPLAY_ON
+		};
+
+		static constexpr uint16_t Index(uint8_t x, uint8_t y)
+		{
+			//FRAMEBUFFER BYTE HOLDING PIXEL x,y
+			return ((uint16_t)(y >> 3) * WIDTH) + x;
+		}
+
+		static constexpr uint8_t Mask(uint8_t y)
+		{
+			//BIT OF PIXEL ROW y WITHIN ITS PAGE BYTE
+			return (uint8_t)(1 << (y & 7));
+		}
+
+		uint8_t Init(uint8_t address)
+		{
+			//SET THE I2C ADDRESS, CLEAR THE FRAMEBUFFER AND SEND THE INIT TABLE
+			//RETURNS 1 IF THE INIT TABLE WAS ACKED
+
+			uint8_t i;
+
+			SH1106_I2C_SetDeviceAddress(address);
+			_orientation = SH1106_I2C_ORIENTATION_ROTATE_0;
+
+			for(i = 0; i < PAGES; i++)
+			{
+				ClearPage(i);
+			}
+
+			return SH1106_I2C_SendCommands(INIT_TABLE, sizeof(INIT_TABLE));
+		}
+
+		uint8_t SetOrientation(uint8_t orientation)
+		{
+			//SAME AS SH1106_I2C_SetOrientation : SEGMENT REMAP AND COM SCAN DIRECTION IN
+			//HARDWARE. THE FRAMEBUFFER IS ONLY RESENT IF THE RAM COLUMN WINDOW MOVES
+			//RETURNS 1 IF EVERYTHING WAS ACKED. THE ORIENTATION ONLY CHANGES ONCE THE COMMANDS ARE
+
+			uint8_t old_ram_column = RamColumn();
+			uint8_t commands[2];
+
+			orientation &= SH1106_I2C_ORIENTATION_ROTATE_180;
+
+			commands[0] = SH1106_I2C_CMD_SET_SEGMENT_REMAP | ((orientation & SH1106_I2C_ORIENTATION_FLIP_HORIZONTAL) ? 0 : 1);
+			commands[1] = SH1106_I2C_CMD_SET_COMMON_SCAN_DIRECTION | ((orientation & SH1106_I2C_ORIENTATION_FLIP_VERTICAL) ? 0 : 8);
+			if(!SH1106_I2C_SendCommands(commands, 2))
+			{
+				return 0;
+			}
+			_orientation = orientation;
+
+			if(RamColumn() != old_ram_column)
+			{
+				return UpdateDisplay();
+			}
+			return 1;
+		}
+
+		void DrawPixel(uint8_t x, uint8_t y, uint8_t color)
+		{
+			//SET OR UNSET A PIXEL AT THE SPECIFIED X,Y LOCATION
+
+			if((x >= WIDTH) || (y >= HEIGHT))
+			{
+				return;
+			}
+
+			if(color)
+			{
+				_framebuffer[Index(x, y)] |= Mask(y);
+			}
+			else
+			{
+				_framebuffer[Index(x, y)] &= ~Mask(y);
+			}
+		}
+
+		void ClearPage(uint8_t page)
+		{
+			//CLEAR ONE PAGE OF THE FRAMEBUFFER
+
+			uint8_t x;
+
+			for(x = 0; x < WIDTH; x++)
+			{
+				_framebuffer[((uint16_t)page * WIDTH) + x] = SH1106_I2C_SCREEN_FILL_PATTERN_CLEAR;
+			}
+		}
+
+		uint8_t UpdatePage(uint8_t page)
+		{
+			//TRANSFER ONE PAGE OF THE FRAMEBUFFER TO THE DISPLAY
+			//RETURNS 1 ON SUCCESS, 0 IF THE PAGE STILL FAILED AFTER ITS RETRIES
+
+			return SH1106_I2C_SendPageData(page, RamColumn(), &_framebuffer[(uint16_t)page * WIDTH], WIDTH);
+		}
+
+		uint8_t UpdateDisplay(void)
+		{
+			//TRANSFER THE FRAMEBUFFER TO THE DISPLAY IN BULK
+			//RETURNS 1 IF EVERY PAGE WENT THROUGH
+
+			uint8_t page;
+			uint8_t ok = 1;
+
+			for(page = 0; page < PAGES; page++)
+			{
+				if(!UpdatePage(page))
+				{
+					ok = 0;
+				}
+			}
+			return ok;
+		}
+
+		uint8_t* GetFramebuffer(void)
+		{
+			//PAGE MAJOR FRAMEBUFFER OF BUFFER_SIZE BYTES
+
+			return _framebuffer;
+		}
+
+	private:
+		uint8_t RamColumn(void) const
+		{
+			//RAM COLUMN OF THE PANEL COLUMN 0. MIRRORED WHEN FLIPPED HORIZONTALLY
+			return (_orientation & SH1106_I2C_ORIENTATION_FLIP_HORIZONTAL) ? (SH1106_I2C_RAM_COLUMNS - WIDTH - COLUMN_OFFSET) : COLUMN_OFFSET;
+		}
+
+		uint8_t _orientation;
+		uint8_t _framebuffer[BUFFER_SIZE];
+};
+
+template<uint8_t WIDTH, uint8_t HEIGHT, uint8_t COLUMN_OFFSET, uint8_t COM_PADS_CONFIG>
+constexpr uint8_t SH1106_I2C_PANEL<WIDTH, HEIGHT, COLUMN_OFFSET, COM_PADS_CONFIG>::INIT_TABLE[];
+
+//COMMON MODULES
+//128x64 WITH THE SAME RAM COLUMN OFFSET AS THE C DRIVER
+typedef SH1106_I2C_PANEL<128, 64, SH1106_I2C_OLED_COLUMN_OFFSET, 0x12> SH1106_I2C_PANEL_128X64;
+//128x64 CENTERED IN THE 132 COLUMN RAM (COLUMNS 2 - 129)
+typedef SH1106_I2C_PANEL<128, 64, 2, 0x12> SH1106_I2C_PANEL_128X64_OFFSET_2;
+//128x32 (SEQUENTIAL COM PADS)
+typedef SH1106_I2C_PANEL<128, 32, SH1106_I2C_OLED_COLUMN_OFFSET, 0x02> SH1106_I2C_PANEL_128X32;
+
+#endif